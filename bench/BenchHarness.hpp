@@ -0,0 +1,320 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "commandLine/CommandLine.hpp"
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define BENCH_HAS_PERF_EVENTS 1
+#endif
+
+// Utilitários compartilhados pelos benchmarks de bench/: medição de tempo, contadores
+// de hardware, leitura de listas na linha de comando e relatório em tabela e em JSON.
+
+namespace bench
+{
+    /**
+     * @brief Impede que o compilador descarte um valor calculado apenas para o benchmark.
+     */
+    template <typename T>
+    inline void do_not_optimize(const T &value)
+    {
+#if defined(__GNUC__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const T *sink;
+        sink = &value;
+#endif
+    }
+
+    template <typename F>
+    double seconds(F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        return elapsed.count();
+    }
+
+    /**
+     * @brief Contadores de hardware do processador lidos com `perf_event_open` (apenas Linux).
+     *
+     * Abre um contador por evento para a thread atual, sem contar o kernel. Eventos que o
+     * processador, a máquina virtual ou `/proc/sys/kernel/perf_event_paranoid` não permitem
+     * são ignorados; em outros sistemas nenhum evento fica disponível. Quando há mais
+     * eventos que registradores, o kernel os multiplexa e os valores são extrapolados pela
+     * fração do tempo em que cada um esteve ativo.
+     *
+     * Só o que acontece entre `start()` e `stop()` é somado.
+     */
+    class PerfCounters
+    {
+    public:
+        static constexpr size_t EVENTS = 6;
+
+        static constexpr std::array<const char *, EVENTS> NAMES{
+            "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses"};
+
+    private:
+        std::array<int, EVENTS> fds;
+        std::array<double, EVENTS> totals{};
+
+        // Valor, tempo habilitado e tempo em execução lidos em `start()`
+        std::array<std::array<uint64_t, 3>, EVENTS> started{};
+
+#if defined(BENCH_HAS_PERF_EVENTS)
+        static int open_event(uint32_t type, uint64_t config)
+        {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+
+        static constexpr uint64_t cache_miss(uint64_t cache)
+        {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        }
+
+        bool read_event(size_t i, std::array<uint64_t, 3> &value) const
+        {
+            return ::read(fds[i], value.data(), sizeof(value)) == static_cast<ssize_t>(sizeof(value));
+        }
+#endif
+
+    public:
+        PerfCounters()
+        {
+            fds.fill(-1);
+
+#if defined(BENCH_HAS_PERF_EVENTS)
+            fds[0] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+            fds[1] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+            fds[2] = open_event(PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D));
+            fds[3] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+            fds[4] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+            fds[5] = open_event(PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_DTLB));
+#endif
+        }
+
+        PerfCounters(const PerfCounters &) = delete;
+        PerfCounters &operator=(const PerfCounters &) = delete;
+
+        ~PerfCounters()
+        {
+#if defined(BENCH_HAS_PERF_EVENTS)
+            for (int fd : fds)
+                if (fd >= 0)
+                    close(fd);
+#endif
+        }
+
+        bool available() const noexcept
+        {
+            for (int fd : fds)
+                if (fd >= 0)
+                    return true;
+
+            return false;
+        }
+
+        void start()
+        {
+#if defined(BENCH_HAS_PERF_EVENTS)
+            for (size_t i = 0; i < EVENTS; i++)
+                if (fds[i] >= 0 and !read_event(i, started[i]))
+                    started[i] = {0, 0, 0};
+#endif
+        }
+
+        void stop()
+        {
+#if defined(BENCH_HAS_PERF_EVENTS)
+            for (size_t i = 0; i < EVENTS; i++)
+            {
+                std::array<uint64_t, 3> now;
+                if (fds[i] < 0 or !read_event(i, now))
+                    continue;
+
+                double value = static_cast<double>(now[0] - started[i][0]);
+                uint64_t enabled = now[1] - started[i][1];
+                uint64_t running = now[2] - started[i][2];
+
+                if (running > 0 and running < enabled)
+                    value *= static_cast<double>(enabled) / static_cast<double>(running);
+
+                totals[i] += value;
+            }
+#endif
+        }
+
+        void reset() noexcept
+        {
+            totals.fill(0.0);
+        }
+
+        /**
+         * @brief Pares (evento, valor por operação) dos eventos disponíveis.
+         */
+        std::vector<std::pair<std::string, double>> per_operation(size_t operations) const
+        {
+            std::vector<std::pair<std::string, double>> values;
+
+            for (size_t i = 0; i < EVENTS; i++)
+                if (fds[i] >= 0)
+                    values.emplace_back(NAMES[i], operations == 0 ? 0.0 : totals[i] / static_cast<double>(operations));
+
+            return values;
+        }
+    };
+
+    /**
+     * @brief Resultado de um benchmark: `operations` operações em `seconds` segundos e,
+     * se medidos, os contadores de hardware por operação.
+     */
+    struct Measurement
+    {
+        std::string benchmark;
+        std::string structure;
+        std::string distribution;
+        size_t size;
+        size_t operations;
+        double seconds;
+        std::vector<std::pair<std::string, double>> counters{};
+
+        double ns_per_op() const
+        {
+            return operations == 0 ? 0.0 : seconds * 1e9 / static_cast<double>(operations);
+        }
+    };
+
+    using cli::json_escape;
+    using cli::split_list;
+
+    /**
+     * @brief Lê tamanhos como "1000,1e6,100M" (aceita os sufixos K e M e notação 1eN).
+     */
+    inline std::vector<size_t> parse_sizes(const std::string &text)
+    {
+        std::vector<size_t> sizes;
+
+        for (const std::string &item : split_list(text))
+        {
+            char *end = nullptr;
+            double value = std::strtod(item.c_str(), &end);
+            if (*end == 'K' or *end == 'k')
+                value *= 1e3;
+            else if (*end == 'M' or *end == 'm')
+                value *= 1e6;
+            else if (*end != '\0')
+                throw std::invalid_argument("Tamanho invalido: " + item);
+
+            sizes.push_back(static_cast<size_t>(value));
+        }
+
+        return sizes;
+    }
+
+    /**
+     * @brief Acumula medições, imprime cada uma ao ser registrada e grava tudo em JSON.
+     */
+    class Report
+    {
+    private:
+        std::string name;
+        std::vector<Measurement> measurements;
+
+    public:
+        explicit Report(std::string name) : name(std::move(name))
+        {
+            std::cout << std::left << std::setw(14) << "benchmark" << std::setw(14) << "estrutura"
+                      << std::setw(14) << "distribuicao" << std::right << std::setw(12) << "tamanho"
+                      << std::setw(14) << "ns/op" << std::endl;
+        }
+
+        void add(Measurement measurement)
+        {
+            std::cout << std::left << std::setw(14) << measurement.benchmark << std::setw(14) << measurement.structure
+                      << std::setw(14) << measurement.distribution << std::right << std::setw(12) << measurement.size
+                      << std::setw(14) << std::fixed << std::setprecision(1) << measurement.ns_per_op();
+
+            for (const auto &[name, value] : measurement.counters)
+                std::cout << "  " << name << "/op=" << std::setprecision(2) << value;
+            std::cout << std::endl;
+
+            measurements.push_back(std::move(measurement));
+        }
+
+        const std::vector<Measurement> &results() const noexcept
+        {
+            return measurements;
+        }
+
+        /**
+         * @brief Grava as medições em `path` como um objeto JSON com a lista `results`.
+         *
+         * @throw std::runtime_error Se o arquivo não puder ser aberto.
+         */
+        void write_json(const std::string &path) const
+        {
+            std::ofstream out(path);
+            if (!out)
+                throw std::runtime_error("Nao foi possivel abrir o arquivo: " + path);
+
+            out << "{\n  \"suite\": \"" << json_escape(name) << "\",\n";
+#if defined(__VERSION__)
+            out << "  \"compiler\": \"" << json_escape(__VERSION__) << "\",\n";
+#endif
+            out << "  \"results\": [\n";
+
+            // Notação fixa: com precisão padrão, 1234.5 viraria 1.23e+03 e perderia dígitos
+            out << std::fixed;
+
+            for (size_t i = 0; i < measurements.size(); i++)
+            {
+                const Measurement &m = measurements[i];
+                out << "    {\"benchmark\": \"" << json_escape(m.benchmark)
+                    << "\", \"structure\": \"" << json_escape(m.structure)
+                    << "\", \"distribution\": \"" << json_escape(m.distribution)
+                    << "\", \"size\": " << m.size
+                    << ", \"operations\": " << m.operations
+                    << ", \"seconds\": " << std::setprecision(9) << m.seconds
+                    << ", \"ns_per_op\": " << std::setprecision(3) << m.ns_per_op();
+
+                if (!m.counters.empty())
+                {
+                    out << ", \"counters_per_op\": {";
+                    for (size_t c = 0; c < m.counters.size(); c++)
+                        out << (c == 0 ? "" : ", ") << "\"" << json_escape(m.counters[c].first) << "\": " << std::setprecision(3) << m.counters[c].second;
+                    out << "}";
+                }
+
+                out << "}" << (i + 1 < measurements.size() ? ",\n" : "\n");
+            }
+
+            out << "  ]\n}\n";
+        }
+    };
+}
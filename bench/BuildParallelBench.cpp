@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "set/Set.hpp"
+
+// Benchmark da construção em lote de um Set a partir de chaves não ordenadas.
+//
+// Uso: BuildParallelBench [chaves] [max_threads]
+//
+// Compara a inserção chave a chave com Set::build_parallel para 1, 2, 4, ...
+// max_threads threads.
+
+namespace
+{
+    template <typename F>
+    double seconds(F f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        return elapsed.count();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t keys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+    unsigned max_threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : std::thread::hardware_concurrency();
+    if (max_threads == 0)
+        max_threads = 1;
+
+    std::mt19937_64 rng(42);
+    std::vector<int64_t> values(keys);
+    for (int64_t &value : values)
+        value = static_cast<int64_t>(rng() >> 1);
+
+    std::cout << keys << " chaves aleatorias" << std::endl;
+
+    double sequential = seconds([&values]()
+                                {
+                                    Set<int64_t> set;
+                                    for (int64_t value : values)
+                                        set.insert(value); });
+
+    std::cout << std::setw(16) << "insert" << std::fixed << std::setprecision(3)
+              << std::setw(10) << sequential << " s" << std::endl;
+
+    double base = 0.0;
+    for (unsigned threads = 1; threads <= max_threads; threads = (threads * 2 > max_threads and threads != max_threads) ? max_threads : threads * 2)
+    {
+        size_t size = 0;
+        double elapsed = seconds([&values, &size, threads]()
+                                 { size = Set<int64_t>::build_parallel(values, threads).size(); });
+        if (threads == 1)
+            base = elapsed;
+
+        std::cout << std::setw(8) << threads << " threads" << std::setw(10) << elapsed << " s"
+                  << std::setw(9) << std::setprecision(2) << base / elapsed << "x"
+                  << std::setw(9) << sequential / elapsed << "x vs insert" << std::setprecision(3)
+                  << " (" << size << " chaves)" << std::endl;
+
+        if (threads == max_threads)
+            break;
+    }
+
+    return 0;
+}
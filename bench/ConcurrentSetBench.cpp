@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "concurrentSet/ConcurrentSet.hpp"
+#include "concurrentSet/EpochSet.hpp"
+
+// Benchmark de escalabilidade de leitura do ConcurrentSet (shared_mutex) e do
+// EpochSet (leitores sem lock).
+//
+// Uso: ConcurrentSetBench [chaves] [consultas_por_thread] [max_threads]
+//
+// Cada thread executa `consultas_por_thread` chamadas a contains() com chaves
+// aleatórias (metade presentes, metade ausentes). A vazão total é comparada com a
+// execução em uma única thread para mostrar o ganho de leitores em paralelo.
+
+namespace
+{
+    template <typename SetType>
+    double runReaders(const SetType &set, int keys, size_t lookups, unsigned threads)
+    {
+        std::vector<std::thread> workers;
+        std::vector<size_t> hits(threads, 0);
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (unsigned t = 0; t < threads; t++)
+        {
+            workers.emplace_back([&set, &hits, keys, lookups, t]()
+                                 {
+                                     std::mt19937 rng(t + 1);
+                                     std::uniform_int_distribution<int> dist(0, 2 * keys - 1);
+                                     size_t found = 0;
+
+                                     for (size_t i = 0; i < lookups; i++)
+                                         found += set.contains(dist(rng));
+
+                                     hits[t] = found; });
+        }
+
+        for (std::thread &worker : workers)
+            worker.join();
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        size_t total = 0;
+        for (size_t h : hits)
+            total += h;
+        if (total == 0)
+            std::cerr << "(nenhuma chave encontrada)" << std::endl;
+
+        return static_cast<double>(lookups) * threads / elapsed.count();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int keys = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+    size_t lookups = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2'000'000;
+    unsigned max_threads = argc > 3 ? static_cast<unsigned>(std::atoi(argv[3])) : std::thread::hardware_concurrency();
+    if (max_threads == 0)
+        max_threads = 1;
+
+    std::vector<int> values;
+    values.reserve(keys);
+    for (int i = 0; i < keys; i++)
+        values.push_back(2 * i); // Apenas pares: metade das consultas erra
+
+    ConcurrentSet<int> locked;
+    locked.insert_all(values.begin(), values.end());
+
+    EpochSet<int> lockFree;
+    lockFree.insert_all(values.begin(), values.end());
+
+    std::cout << keys << " chaves, " << lookups << " consultas por thread" << std::endl;
+    std::cout << std::setw(8) << "threads"
+              << std::setw(16) << "locked Mops/s" << std::setw(10) << "speedup"
+              << std::setw(16) << "epoch Mops/s" << std::setw(10) << "speedup" << std::endl;
+
+    double lockedBase = 0.0, epochBase = 0.0;
+    for (unsigned threads = 1; threads <= max_threads; threads = (threads * 2 > max_threads and threads != max_threads) ? max_threads : threads * 2)
+    {
+        double lockedThroughput = runReaders(locked, keys, lookups, threads);
+        double epochThroughput = runReaders(lockFree, keys, lookups, threads);
+        if (threads == 1)
+        {
+            lockedBase = lockedThroughput;
+            epochBase = epochThroughput;
+        }
+
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(2)
+                  << std::setw(16) << lockedThroughput / 1e6 << std::setw(9) << lockedThroughput / lockedBase << "x"
+                  << std::setw(16) << epochThroughput / 1e6 << std::setw(9) << epochThroughput / epochBase << "x" << std::endl;
+
+        if (threads == max_threads)
+            break;
+    }
+
+    return 0;
+}
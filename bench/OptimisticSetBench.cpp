@@ -0,0 +1,109 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "concurrentSet/ConcurrentSet.hpp"
+#include "concurrentSet/OptimisticSet.hpp"
+
+// Benchmark de vazão com escritas concorrentes: ConcurrentSet (lock global de
+// leitores/escritor) contra OptimisticSet (locks por nó e buscas otimistas).
+//
+// Uso: OptimisticSetBench [chaves] [operacoes_por_thread] [percentual_escritas] [max_threads]
+//
+// Cada thread executa uma mistura de insert/erase/contains sobre chaves aleatórias em
+// [0, 2 * chaves); as escritas são divididas igualmente entre inserções e remoções,
+// mantendo o conjunto com cerca de `chaves` elementos.
+
+namespace
+{
+    template <typename SetType>
+    double runMixed(SetType &set, int keys, size_t operations, int writePercent, unsigned threads)
+    {
+        std::vector<std::thread> workers;
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (unsigned t = 0; t < threads; t++)
+        {
+            workers.emplace_back([&set, keys, operations, writePercent, t]()
+                                 {
+                                     std::mt19937 rng(t + 1);
+                                     std::uniform_int_distribution<int> key(0, 2 * keys - 1);
+                                     std::uniform_int_distribution<int> percent(0, 99);
+
+                                     for (size_t i = 0; i < operations; i++)
+                                     {
+                                         int op = percent(rng);
+                                         if (op < writePercent / 2)
+                                             set.insert(key(rng));
+                                         else if (op < writePercent)
+                                             set.erase(key(rng));
+                                         else
+                                             set.contains(key(rng));
+                                     } });
+        }
+
+        for (std::thread &worker : workers)
+            worker.join();
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        return static_cast<double>(operations) * threads / elapsed.count();
+    }
+
+    template <typename SetType>
+    void fill(SetType &set, int keys)
+    {
+        std::mt19937 rng(0);
+        std::uniform_int_distribution<int> key(0, 2 * keys - 1);
+
+        while (set.size() < static_cast<size_t>(keys))
+            set.insert(key(rng));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int keys = argc > 1 ? std::atoi(argv[1]) : 1 << 16;
+    size_t operations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1'000'000;
+    int writePercent = argc > 3 ? std::atoi(argv[3]) : 50;
+    unsigned max_threads = argc > 4 ? static_cast<unsigned>(std::atoi(argv[4])) : std::thread::hardware_concurrency();
+    if (max_threads == 0)
+        max_threads = 1;
+
+    std::cout << keys << " chaves, " << operations << " operacoes por thread, "
+              << writePercent << "% escritas" << std::endl;
+    std::cout << std::setw(8) << "threads"
+              << std::setw(16) << "locked Mops/s" << std::setw(10) << "speedup"
+              << std::setw(16) << "optim. Mops/s" << std::setw(10) << "speedup" << std::endl;
+
+    double lockedBase = 0.0, optimisticBase = 0.0;
+    for (unsigned threads = 1; threads <= max_threads; threads = (threads * 2 > max_threads and threads != max_threads) ? max_threads : threads * 2)
+    {
+        ConcurrentSet<int> locked;
+        fill(locked, keys);
+        OptimisticSet<int> optimistic;
+        fill(optimistic, keys);
+
+        double lockedThroughput = runMixed(locked, keys, operations, writePercent, threads);
+        double optimisticThroughput = runMixed(optimistic, keys, operations, writePercent, threads);
+        if (threads == 1)
+        {
+            lockedBase = lockedThroughput;
+            optimisticBase = optimisticThroughput;
+        }
+
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(2)
+                  << std::setw(16) << lockedThroughput / 1e6 << std::setw(9) << lockedThroughput / lockedBase << "x"
+                  << std::setw(16) << optimisticThroughput / 1e6 << std::setw(9) << optimisticThroughput / optimisticBase << "x" << std::endl;
+
+        if (threads == max_threads)
+            break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,515 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.hpp"
+#include "set/Set.hpp"
+#include "workload/Workload.hpp"
+
+// Benchmark das operações de Set comparado com std::set e com um std::vector ordenado.
+//
+// Uso: SetBench [--sizes 1K,10K,100K,1M] [--distributions ascending,uniform,...]
+//               [--structures Set,std::set,sorted_vector]
+//               [--benchmarks insert,erase,...] [--json arquivo] [--perf on]
+//
+// As distribuições são os padrões de workload::keys (ascending, descending, alternating,
+// uniform e clustered), sempre com a mesma semente. Para cada estrutura, distribuição
+// de chaves e tamanho n mede:
+//   insert, erase, clear              n operações a partir de uma estrutura nova
+//   contains                          LOOKUPS buscas, metade de chaves ausentes
+//   zipf_contains                     LOOKUPS buscas de chaves presentes com popularidade Zipf
+//   successor, predecessor            LOOKUPS consultas de chaves presentes
+//   union, intersection, difference   com outra estrutura de n chaves, metade em comum
+//   copy                              cópia da estrutura inteira
+//   churn                             n inserções, remoções e buscas intercaladas
+//
+// Com --perf on, cada medição também mostra os contadores de hardware por operação
+// (ciclos, instruções, falhas de L1d, de LLC, de previsão de desvio e de dTLB) lidos
+// com perf_event_open em volta de cada repetição; no JSON ficam em "counters_per_op".
+//
+// Operações O(n) por elemento no vetor ordenado (insert, erase, churn) só são medidas até
+// SORTED_VECTOR_LIMIT chaves.
+
+namespace
+{
+    constexpr size_t LOOKUPS = 1'000'000;
+    constexpr size_t SORTED_VECTOR_LIMIT = 100'000;
+    constexpr uint64_t SEED = 42;
+    constexpr double ZIPF_EXPONENT = 0.99;
+
+    /**
+     * @brief Cada medição repete a operação até somar pelo menos este tempo, ou até que
+     * o tempo total, incluindo a preparação, passe de `MAX_WALL_SECONDS`.
+     */
+    constexpr double MIN_SECONDS = 0.1;
+    constexpr double MAX_WALL_SECONDS = 1.0;
+
+    using Key = int64_t;
+
+    /**
+     * @brief Contadores de hardware em uso, ou `nullptr` se não foram pedidos com `--perf on`.
+     */
+    bench::PerfCounters *perf = nullptr;
+
+    struct AvlSet
+    {
+        static constexpr const char *NAME = "Set";
+        Set<Key> set;
+
+        void insert(Key key) { set.insert(key); }
+        void erase(Key key) { set.erase(key); }
+        bool contains(Key key) const { return set.contains(key); }
+        Key successor(Key key) const { return set.successor(key); }
+        Key predecessor(Key key) const { return set.predecessor(key); }
+        size_t size() const { return set.size(); }
+        void clear() { set.clear(); }
+
+        AvlSet set_union(const AvlSet &other) const { return {set.Union(other.set)}; }
+        AvlSet set_intersection(const AvlSet &other) const { return {set.Intersection(other.set)}; }
+        AvlSet set_difference(const AvlSet &other) const { return {set.Difference(other.set)}; }
+    };
+
+    struct StdSet
+    {
+        static constexpr const char *NAME = "std::set";
+        std::set<Key> set;
+
+        void insert(Key key) { set.insert(key); }
+        void erase(Key key) { set.erase(key); }
+        bool contains(Key key) const { return set.count(key) != 0; }
+        Key successor(Key key) const { return *set.upper_bound(key); }
+        Key predecessor(Key key) const { return *std::prev(set.lower_bound(key)); }
+        size_t size() const { return set.size(); }
+        void clear() { set.clear(); }
+
+        StdSet set_union(const StdSet &other) const
+        {
+            StdSet result;
+            std::set_union(set.begin(), set.end(), other.set.begin(), other.set.end(), std::inserter(result.set, result.set.end()));
+            return result;
+        }
+
+        StdSet set_intersection(const StdSet &other) const
+        {
+            StdSet result;
+            std::set_intersection(set.begin(), set.end(), other.set.begin(), other.set.end(), std::inserter(result.set, result.set.end()));
+            return result;
+        }
+
+        StdSet set_difference(const StdSet &other) const
+        {
+            StdSet result;
+            std::set_difference(set.begin(), set.end(), other.set.begin(), other.set.end(), std::inserter(result.set, result.set.end()));
+            return result;
+        }
+    };
+
+    struct SortedVector
+    {
+        static constexpr const char *NAME = "sorted_vector";
+        std::vector<Key> keys;
+
+        void insert(Key key)
+        {
+            auto it = std::lower_bound(keys.begin(), keys.end(), key);
+            if (it == keys.end() or *it != key)
+                keys.insert(it, key);
+        }
+
+        void erase(Key key)
+        {
+            auto it = std::lower_bound(keys.begin(), keys.end(), key);
+            if (it != keys.end() and *it == key)
+                keys.erase(it);
+        }
+
+        bool contains(Key key) const { return std::binary_search(keys.begin(), keys.end(), key); }
+        Key successor(Key key) const { return *std::upper_bound(keys.begin(), keys.end(), key); }
+        Key predecessor(Key key) const { return *std::prev(std::lower_bound(keys.begin(), keys.end(), key)); }
+        size_t size() const { return keys.size(); }
+        void clear() { keys.clear(); }
+
+        SortedVector set_union(const SortedVector &other) const
+        {
+            SortedVector result;
+            std::set_union(keys.begin(), keys.end(), other.keys.begin(), other.keys.end(), std::back_inserter(result.keys));
+            return result;
+        }
+
+        SortedVector set_intersection(const SortedVector &other) const
+        {
+            SortedVector result;
+            std::set_intersection(keys.begin(), keys.end(), other.keys.begin(), other.keys.end(), std::back_inserter(result.keys));
+            return result;
+        }
+
+        SortedVector set_difference(const SortedVector &other) const
+        {
+            SortedVector result;
+            std::set_difference(keys.begin(), keys.end(), other.keys.begin(), other.keys.end(), std::back_inserter(result.keys));
+            return result;
+        }
+    };
+
+    template <class Structure>
+    Structure build(const std::vector<Key> &keys)
+    {
+        Structure structure;
+
+        if constexpr (std::is_same_v<Structure, SortedVector>)
+        {
+            structure.keys = keys;
+            std::sort(structure.keys.begin(), structure.keys.end());
+            structure.keys.erase(std::unique(structure.keys.begin(), structure.keys.end()), structure.keys.end());
+        }
+        else
+        {
+            for (Key key : keys)
+                structure.insert(key);
+        }
+
+        return structure;
+    }
+
+    /**
+     * @brief Atribui a `structure` uma cópia de `full` que não compartilha nada com ela.
+     *
+     * A cópia de `Set` compartilha os nós (copy-on-write), e cada remoção medida incluiria
+     * a cópia do caminho até a chave; por isso o `Set` é remontado em O(n) a partir das
+     * chaves ordenadas (`sorted`), como as outras estruturas, que fazem cópias completas.
+     */
+    template <class Structure>
+    void assign_private(Structure &structure, const Structure &full, const std::vector<Key> &sorted)
+    {
+        if constexpr (std::is_same_v<Structure, AvlSet>)
+        {
+            Set<Key> built = Set<Key>::from_sorted(sorted);
+            structure.set.swap(built);
+        }
+        else
+        {
+            structure = full;
+        }
+    }
+
+    /**
+     * @brief Repete `body` (precedido de `setup`, fora da medição) até somar `MIN_SECONDS`.
+     *
+     * Os contadores de hardware, se habilitados, são zerados no início e acumulam apenas
+     * as execuções de `body`.
+     *
+     * @return Par (segundos medidos, repetições).
+     */
+    template <typename Setup, typename Body>
+    std::pair<double, size_t> repeat(Setup setup, Body body)
+    {
+        auto start = std::chrono::steady_clock::now();
+        double total = 0.0;
+        size_t reps = 0;
+
+        if (perf)
+            perf->reset();
+
+        while (total < MIN_SECONDS)
+        {
+            setup();
+
+            if (perf)
+                perf->start();
+            total += bench::seconds(body);
+            if (perf)
+                perf->stop();
+
+            reps++;
+
+            std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+            if (wall.count() > MAX_WALL_SECONDS)
+                break;
+        }
+
+        return {total, reps};
+    }
+
+    /**
+     * @brief Chaves do padrão multiplicadas por 2, para que chave + 1 seja sempre ausente.
+     */
+    std::vector<Key> generate(workload::Pattern pattern, size_t n, uint64_t seed)
+    {
+        std::vector<Key> keys = workload::keys(pattern, n, seed);
+        for (Key &key : keys)
+            key = static_cast<Key>(static_cast<uint64_t>(key) << 1);
+
+        return keys;
+    }
+
+    struct Options
+    {
+        std::vector<size_t> sizes{1'000, 10'000, 100'000, 1'000'000};
+        std::vector<std::string> distributions{"ascending", "descending", "alternating", "uniform", "clustered"};
+        std::vector<std::string> structures{AvlSet::NAME, StdSet::NAME, SortedVector::NAME};
+        std::vector<std::string> benchmarks{"insert", "erase", "contains", "zipf_contains", "successor", "predecessor",
+                                            "union", "intersection", "difference", "copy", "clear", "churn"};
+        std::string json;
+        bool perf{false};
+    };
+
+    bool selected(const std::vector<std::string> &list, const std::string &name)
+    {
+        return std::find(list.begin(), list.end(), name) != list.end();
+    }
+
+    template <class Structure>
+    void run(const Options &options, const std::string &distribution, size_t n, const std::vector<Key> &keys,
+             const std::vector<Key> &other_keys, bench::Report &report)
+    {
+        auto record = [&](const char *benchmark, size_t operations_per_rep, std::pair<double, size_t> result)
+        {
+            size_t operations = operations_per_rep * result.second;
+            report.add({benchmark, Structure::NAME, distribution, n, operations, result.first,
+                        perf ? perf->per_operation(operations) : std::vector<std::pair<std::string, double>>{}});
+        };
+
+        bool quadratic = std::is_same_v<Structure, SortedVector> and n > SORTED_VECTOR_LIMIT;
+        workload::Rng rng(7);
+
+        if (selected(options.benchmarks, "insert") and !quadratic)
+        {
+            Structure structure;
+            record("insert", n, repeat([&]()
+                                       { structure.clear(); },
+                                       [&]()
+                                       {
+                                           for (Key key : keys)
+                                               structure.insert(key); }));
+        }
+
+        Structure full = build<Structure>(keys);
+
+        std::vector<Key> sorted = keys;
+        std::sort(sorted.begin(), sorted.end());
+        sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+        if (selected(options.benchmarks, "erase") and !quadratic)
+        {
+            std::vector<Key> order = keys;
+            workload::shuffle(order, rng);
+
+            Structure structure;
+            record("erase", n, repeat([&]()
+                                      { assign_private(structure, full, sorted); },
+                                      [&]()
+                                      {
+                                          for (Key key : order)
+                                              structure.erase(key); }));
+        }
+
+        if (selected(options.benchmarks, "contains"))
+        {
+            std::vector<Key> queries(LOOKUPS);
+            for (size_t i = 0; i < LOOKUPS; i++)
+                queries[i] = keys[rng.uniform(n)] + static_cast<Key>(i % 2); // Chaves ímpares são ausentes
+
+            record("contains", LOOKUPS, repeat([]() {}, [&]()
+                                               {
+                                                   size_t found = 0;
+                                                   for (Key key : queries)
+                                                       found += full.contains(key);
+                                                   bench::do_not_optimize(found); }));
+        }
+
+        if (selected(options.benchmarks, "zipf_contains"))
+        {
+            std::vector<workload::Operation> lookups = workload::zipf_lookups(keys, LOOKUPS, ZIPF_EXPONENT, SEED);
+
+            record("zipf_contains", LOOKUPS, repeat([]() {}, [&]()
+                                                    {
+                                                        size_t found = 0;
+                                                        for (const workload::Operation &lookup : lookups)
+                                                            found += full.contains(lookup.key);
+                                                        bench::do_not_optimize(found); }));
+        }
+
+        if ((selected(options.benchmarks, "successor") or selected(options.benchmarks, "predecessor")) and sorted.size() > 2)
+        {
+            // Exclui os extremos, que não têm sucessor ou predecessor
+            std::vector<Key> queries(LOOKUPS);
+            for (Key &query : queries)
+                query = sorted[1 + rng.uniform(sorted.size() - 2)];
+
+            for (const char *name : {"successor", "predecessor"})
+            {
+                if (!selected(options.benchmarks, name))
+                    continue;
+
+                bool forward = std::strcmp(name, "successor") == 0;
+                record(name, LOOKUPS, repeat([]() {}, [&]()
+                                             {
+                                                 Key sum = 0;
+                                                 for (Key key : queries)
+                                                     sum += forward ? full.successor(key) : full.predecessor(key);
+                                                 bench::do_not_optimize(sum); }));
+            }
+        }
+
+        if (selected(options.benchmarks, "union") or selected(options.benchmarks, "intersection") or
+            selected(options.benchmarks, "difference"))
+        {
+            Structure other = build<Structure>(other_keys);
+
+            if (selected(options.benchmarks, "union"))
+                record("union", n, repeat([]() {}, [&]()
+                                          { bench::do_not_optimize(full.set_union(other).size()); }));
+
+            if (selected(options.benchmarks, "intersection"))
+                record("intersection", n, repeat([]() {}, [&]()
+                                                 { bench::do_not_optimize(full.set_intersection(other).size()); }));
+
+            if (selected(options.benchmarks, "difference"))
+                record("difference", n, repeat([]() {}, [&]()
+                                               { bench::do_not_optimize(full.set_difference(other).size()); }));
+        }
+
+        if (selected(options.benchmarks, "copy"))
+        {
+            record("copy", 1, repeat([]() {}, [&]()
+                                     {
+                                         Structure copy = full;
+                                         bench::do_not_optimize(copy.size()); }));
+        }
+
+        if (selected(options.benchmarks, "clear"))
+        {
+            Structure structure;
+            record("clear", n, repeat([&]()
+                                      { structure = build<Structure>(keys); },
+                                      [&]()
+                                      { structure.clear(); }));
+        }
+
+        if (selected(options.benchmarks, "churn") and !quadratic)
+        {
+            // A fase de inserção das chaves iniciais fica fora da medição
+            std::vector<workload::Operation> operations = workload::churn(keys, n, SEED);
+            std::vector<workload::Operation> mixed(operations.begin() + keys.size(), operations.end());
+
+            Structure structure;
+            record("churn", n, repeat([&]()
+                                      { assign_private(structure, full, sorted); },
+                                      [&]()
+                                      {
+                                          size_t found = 0;
+                                          for (const workload::Operation &operation : mixed)
+                                          {
+                                              if (operation.type == workload::OpType::Insert)
+                                                  structure.insert(operation.key);
+                                              else if (operation.type == workload::OpType::Erase)
+                                                  structure.erase(operation.key);
+                                              else
+                                                  found += structure.contains(operation.key);
+                                          }
+                                          bench::do_not_optimize(found); }));
+        }
+    }
+
+    Options parse(int argc, char *argv[])
+    {
+        Options options;
+
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            std::string flag = argv[i];
+            std::string value = argv[i + 1];
+
+            if (flag == "--sizes")
+                options.sizes = bench::parse_sizes(value);
+            else if (flag == "--distributions")
+                options.distributions = bench::split_list(value);
+            else if (flag == "--structures")
+                options.structures = bench::split_list(value);
+            else if (flag == "--benchmarks")
+                options.benchmarks = bench::split_list(value);
+            else if (flag == "--json")
+                options.json = value;
+            else if (flag == "--perf")
+                options.perf = value == "on";
+            else
+                throw std::invalid_argument("Opcao desconhecida: " + flag);
+        }
+
+        return options;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    try
+    {
+        options = parse(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    bench::PerfCounters counters;
+    if (options.perf)
+    {
+        if (counters.available())
+            perf = &counters;
+        else
+            std::cerr << "Contadores de hardware indisponiveis (perf_event_open); medindo apenas o tempo" << std::endl;
+    }
+
+    bench::Report report("SetBench");
+
+    for (const std::string &distribution : options.distributions)
+    {
+        workload::Pattern pattern;
+        try
+        {
+            pattern = workload::parse_pattern(distribution);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+
+        for (size_t n : options.sizes)
+        {
+            if (n == 0)
+                continue;
+
+            std::vector<Key> keys = generate(pattern, n, SEED);
+
+            // Metade das chaves em comum com `keys`, metade novas (deslocadas para fora do
+            // intervalo dos padrões determinísticos; nos aleatórios a outra semente basta)
+            std::vector<Key> other_keys(keys.begin(), keys.begin() + n / 2);
+            for (Key key : generate(pattern, n - n / 2, SEED + 1))
+                other_keys.push_back(static_cast<Key>(static_cast<uint64_t>(key) + 2 * n));
+
+            if (selected(options.structures, AvlSet::NAME))
+                run<AvlSet>(options, distribution, n, keys, other_keys, report);
+            if (selected(options.structures, StdSet::NAME))
+                run<StdSet>(options, distribution, n, keys, other_keys, report);
+            if (selected(options.structures, SortedVector::NAME))
+                run<SortedVector>(options, distribution, n, keys, other_keys, report);
+        }
+    }
+
+    if (!options.json.empty())
+    {
+        report.write_json(options.json);
+        std::cout << "Resultados gravados em " << options.json << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Estatísticas de um `BloomFilter`, usadas para dimensionar o filtro.
+ *
+ * - `bits`: quantidade total de bits alocados no filtro.
+ * - `hashes`: número de bits marcados por chave (k).
+ * - `keys`: chaves adicionadas desde a última reconstrução.
+ * - `estimated_fpr`: taxa de falsos positivos estimada a partir da ocupação dos bits.
+ * - `observed_fpr`: taxa de falsos positivos observada nas consultas por chaves ausentes.
+ * - `queries`: total de consultas feitas ao filtro.
+ * - `negatives`: consultas respondidas pelo filtro sem percorrer a árvore.
+ * - `false_positives`: consultas em que o filtro respondeu "talvez" e a chave não existia.
+ * - `erases_since_rebuild`: remoções acumuladas desde a última reconstrução.
+ * - `rebuilds`: número de reconstruções realizadas.
+ */
+struct BloomFilterStats
+{
+    size_t bits{0};
+    size_t hashes{0};
+    size_t keys{0};
+    double estimated_fpr{0.0};
+    double observed_fpr{0.0};
+    size_t queries{0};
+    size_t negatives{0};
+    size_t false_positives{0};
+    size_t erases_since_rebuild{0};
+    size_t rebuilds{0};
+};
+
+/**
+ * @brief Filtro de Bloom em blocos (blocked Bloom filter) para acelerar buscas negativas.
+ *
+ * Cada chave é mapeada para um único bloco de 512 bits (uma linha de cache) e marca
+ * `k` bits dentro dele. Assim, uma consulta toca apenas uma linha de cache. O filtro
+ * nunca produz falsos negativos: se `may_contain` retornar `false`, a chave certamente
+ * não foi adicionada.
+ *
+ * Como bits não podem ser removidos, o filtro apenas contabiliza remoções; cabe ao dono
+ * (o `Set`) reconstruí-lo quando `needs_rebuild` indicar que ele está saturado.
+ *
+ * Os contadores de consulta são atômicos (ordem relaxada) para que leituras concorrentes
+ * sob um lock compartilhado não gerem condição de corrida.
+ *
+ * @tparam T Tipo das chaves. Deve possuir especialização de `std::hash<T>`.
+ */
+template <typename T>
+class BloomFilter
+{
+private:
+    struct alignas(64) Block
+    {
+        std::array<uint64_t, 8> words{};
+    };
+
+    static constexpr size_t BLOCK_BITS = 512;
+
+    std::vector<Block> blocks;
+    double bits_per_key_m;
+    size_t hashes_m;
+    size_t capacity_m;
+    size_t keys_m{0};
+    size_t erases_m{0};
+    size_t rebuilds_m{0};
+
+    mutable std::atomic<size_t> queries_m{0};
+    mutable std::atomic<size_t> negatives_m{0};
+    mutable std::atomic<size_t> false_positives_m{0};
+
+    /**
+     * @brief Finalizador do splitmix64, espalha os bits de `std::hash` (que é a identidade para inteiros).
+     */
+    static uint64_t mix(uint64_t x) noexcept
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    static uint64_t hash(const T &key)
+    {
+        return mix(static_cast<uint64_t>(std::hash<T>{}(key)));
+    }
+
+    /**
+     * @brief Escolhe o bloco com os 32 bits altos do hash (redução multiplicativa, sem módulo).
+     */
+    const Block &block_for(uint64_t h) const noexcept
+    {
+        return blocks[static_cast<size_t>(((h >> 32) * blocks.size()) >> 32)];
+    }
+
+    Block &block_for(uint64_t h) noexcept
+    {
+        return blocks[static_cast<size_t>(((h >> 32) * blocks.size()) >> 32)];
+    }
+
+    /**
+     * @brief Chama `f(palavra, máscara)` para cada um dos `k` bits da chave dentro do bloco.
+     *
+     * Cada posição consome 9 bits de um segundo hash; quando eles se esgotam o hash é
+     * remisturado.
+     */
+    template <typename F>
+    void for_each_bit(uint64_t h, F f) const
+    {
+        uint64_t bits = mix(h);
+        int available = 64;
+
+        for (size_t i = 0; i < hashes_m; i++)
+        {
+            if (available < 9)
+            {
+                bits = mix(bits);
+                available = 64;
+            }
+
+            size_t pos = bits & (BLOCK_BITS - 1);
+            bits >>= 9;
+            available -= 9;
+
+            if (!f(pos >> 6, uint64_t{1} << (pos & 63)))
+                return;
+        }
+    }
+
+public:
+    /**
+     * @brief Cria um filtro dimensionado para `capacity` chaves.
+     *
+     * @param capacity Número de chaves esperado (mínimo 1).
+     * @param bits_per_key Bits por chave; 10 bits resulta em cerca de 1% de falsos positivos.
+     */
+    explicit BloomFilter(size_t capacity, double bits_per_key = 10.0)
+        : bits_per_key_m(std::max(bits_per_key, 1.0)),
+          hashes_m(std::clamp<size_t>(static_cast<size_t>(std::lround(bits_per_key_m * 0.693)), 1, 16)),
+          capacity_m(std::max<size_t>(capacity, 1))
+    {
+        size_t total_bits = static_cast<size_t>(std::ceil(capacity_m * bits_per_key_m));
+        blocks.resize(std::max<size_t>(1, (total_bits + BLOCK_BITS - 1) / BLOCK_BITS));
+    }
+
+    BloomFilter(const BloomFilter &other)
+        : blocks(other.blocks), bits_per_key_m(other.bits_per_key_m), hashes_m(other.hashes_m),
+          capacity_m(other.capacity_m), keys_m(other.keys_m), erases_m(other.erases_m),
+          rebuilds_m(other.rebuilds_m), queries_m(other.queries_m.load(std::memory_order_relaxed)),
+          negatives_m(other.negatives_m.load(std::memory_order_relaxed)),
+          false_positives_m(other.false_positives_m.load(std::memory_order_relaxed)) {}
+
+    BloomFilter &operator=(const BloomFilter &other) = delete;
+
+    /**
+     * @brief Marca os bits da chave no filtro.
+     */
+    void add(const T &key)
+    {
+        uint64_t h = hash(key);
+        Block &block = block_for(h);
+
+        for_each_bit(h, [&block](size_t word, uint64_t mask)
+                     {
+                         block.words[word] |= mask;
+                         return true; });
+
+        keys_m++;
+    }
+
+    /**
+     * @brief Verifica se a chave pode estar no conjunto.
+     *
+     * @return false Se a chave certamente não foi adicionada.
+     * @return true Se a chave talvez tenha sido adicionada.
+     */
+    bool may_contain(const T &key) const
+    {
+        uint64_t h = hash(key);
+        const Block &block = block_for(h);
+        bool present = true;
+
+        for_each_bit(h, [&block, &present](size_t word, uint64_t mask)
+                     { return present = (block.words[word] & mask) != 0; });
+
+        queries_m.fetch_add(1, std::memory_order_relaxed);
+        if (!present)
+            negatives_m.fetch_add(1, std::memory_order_relaxed);
+
+        return present;
+    }
+
+    /**
+     * @brief Registra que uma resposta "talvez" do filtro era, na verdade, uma chave ausente.
+     */
+    void record_false_positive() const noexcept
+    {
+        false_positives_m.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Registra a remoção de uma chave (os bits dela continuam marcados).
+     */
+    void note_erase() noexcept
+    {
+        erases_m++;
+    }
+
+    /**
+     * @brief Indica se o filtro deve ser reconstruído.
+     *
+     * Isso acontece quando as remoções acumuladas passam de um quarto das chaves
+     * (bits "mortos" demais) ou quando as inserções ultrapassam o dobro da capacidade
+     * planejada (taxa de falsos positivos degradada).
+     *
+     * @param live_keys Número atual de chaves no conjunto.
+     */
+    bool needs_rebuild(size_t live_keys) const noexcept
+    {
+        return erases_m > std::max<size_t>(live_keys / 4, 64) or keys_m > 2 * capacity_m;
+    }
+
+    /**
+     * @brief Zera os bits e redimensiona o filtro para `capacity` chaves.
+     *
+     * As estatísticas de consulta são preservadas e o contador de reconstruções é incrementado.
+     */
+    void reset(size_t capacity)
+    {
+        capacity_m = std::max<size_t>(capacity, 1);
+        size_t total_bits = static_cast<size_t>(std::ceil(capacity_m * bits_per_key_m));
+
+        blocks.assign(std::max<size_t>(1, (total_bits + BLOCK_BITS - 1) / BLOCK_BITS), Block{});
+        keys_m = 0;
+        erases_m = 0;
+        rebuilds_m++;
+    }
+
+    /**
+     * @brief Remove todos os bits sem alterar o tamanho nem contar como reconstrução.
+     */
+    void clear() noexcept
+    {
+        std::fill(blocks.begin(), blocks.end(), Block{});
+        keys_m = 0;
+        erases_m = 0;
+    }
+
+    double bits_per_key() const noexcept
+    {
+        return bits_per_key_m;
+    }
+
+    /**
+     * @brief Retorna as estatísticas do filtro.
+     *
+     * A taxa estimada usa a fração de bits marcados elevada a `k`, que é a probabilidade
+     * de uma chave ausente encontrar todos os seus bits já marcados.
+     */
+    BloomFilterStats stats() const
+    {
+        size_t set_bits = 0;
+        for (const Block &block : blocks)
+            for (uint64_t word : block.words)
+                set_bits += static_cast<size_t>(std::popcount(word));
+
+        BloomFilterStats s;
+        s.bits = blocks.size() * BLOCK_BITS;
+        s.hashes = hashes_m;
+        s.keys = keys_m;
+        s.estimated_fpr = std::pow(static_cast<double>(set_bits) / s.bits, static_cast<double>(hashes_m));
+        s.queries = queries_m.load(std::memory_order_relaxed);
+        s.negatives = negatives_m.load(std::memory_order_relaxed);
+        s.false_positives = false_positives_m.load(std::memory_order_relaxed);
+        s.observed_fpr = (s.negatives + s.false_positives) == 0
+                             ? 0.0
+                             : static_cast<double>(s.false_positives) / (s.negatives + s.false_positives);
+        s.erases_since_rebuild = erases_m;
+        s.rebuilds = rebuilds_m;
+        return s;
+    }
+};
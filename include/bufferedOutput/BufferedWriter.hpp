@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <locale>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief Saída de texto com buffer fixo para imprimir muitas chaves.
+ *
+ * O texto é acumulado em um buffer interno (sem alocações) e enviado ao destino em
+ * blocos de `BUFFER_SIZE` bytes. O destino pode ser um `std::ostream *` ou qualquer
+ * iterador de saída de `char`.
+ *
+ * Inteiros são formatados com `std::to_chars`. Os demais tipos, e inteiros quando o
+ * `std::ostream` de destino tem formatação diferente da padrão (base, largura, locale),
+ * passam por `operator<<`, de modo que o texto gerado é idêntico ao de `out << chave`.
+ *
+ * @tparam Sink `std::ostream *` ou um iterador de saída de `char`.
+ */
+template <class Sink>
+class BufferedWriter
+{
+private:
+    static constexpr size_t BUFFER_SIZE = 1 << 14;
+
+    /**
+     * @brief Espaço sempre disponível antes de formatar um inteiro (cabe um `__int128`).
+     */
+    static constexpr size_t MAX_INTEGER_CHARS = 64;
+
+    static constexpr bool TO_STREAM = std::is_same_v<Sink, std::ostream *>;
+
+    Sink sink;
+    std::array<char, BUFFER_SIZE> buffer;
+    size_t used{0};
+    bool plain_integers{true};
+    std::optional<std::ostringstream> scratch;
+
+    template <typename K>
+    static constexpr bool IS_TO_CHARS_INTEGER = std::is_integral_v<K> and
+                                               !std::is_same_v<K, bool> and
+                                               !std::is_same_v<K, char> and
+                                               !std::is_same_v<K, signed char> and
+                                               !std::is_same_v<K, unsigned char> and
+                                               !std::is_same_v<K, wchar_t> and
+                                               !std::is_same_v<K, char8_t> and
+                                               !std::is_same_v<K, char16_t> and
+                                               !std::is_same_v<K, char32_t>;
+
+    template <typename K>
+    void write_streamed(const K &key)
+    {
+        if (!scratch)
+        {
+            scratch.emplace();
+            if constexpr (TO_STREAM)
+                scratch->copyfmt(*sink);
+        }
+
+        scratch->str(std::string());
+        *scratch << key;
+        write(scratch->view());
+    }
+
+public:
+    explicit BufferedWriter(Sink sink) : sink(sink)
+    {
+        if constexpr (TO_STREAM)
+            plain_integers = sink->flags() == (std::ios_base::skipws | std::ios_base::dec) and
+                             sink->width() == 0 and
+                             sink->getloc() == std::locale::classic();
+    }
+
+    BufferedWriter(const BufferedWriter &) = delete;
+    BufferedWriter &operator=(const BufferedWriter &) = delete;
+
+    ~BufferedWriter()
+    {
+        flush();
+    }
+
+    /**
+     * @brief Acrescenta um texto ao buffer.
+     */
+    void write(std::string_view text)
+    {
+        while (!text.empty())
+        {
+            if (used == BUFFER_SIZE)
+                flush();
+
+            size_t chunk = std::min(text.size(), BUFFER_SIZE - used);
+            std::copy_n(text.data(), chunk, buffer.data() + used);
+            used += chunk;
+            text.remove_prefix(chunk);
+        }
+    }
+
+    void write(char c)
+    {
+        if (used == BUFFER_SIZE)
+            flush();
+
+        buffer[used++] = c;
+    }
+
+    /**
+     * @brief Acrescenta `key` formatada como `out << key`.
+     */
+    template <typename K>
+    void write_key(const K &key)
+    {
+        if constexpr (IS_TO_CHARS_INTEGER<K>)
+        {
+            if (plain_integers)
+            {
+                if (BUFFER_SIZE - used < MAX_INTEGER_CHARS)
+                    flush();
+
+                used = std::to_chars(buffer.data() + used, buffer.data() + BUFFER_SIZE, key).ptr - buffer.data();
+                return;
+            }
+        }
+
+        if constexpr (std::is_convertible_v<const K &, std::string_view>)
+            write(std::string_view(key));
+        else
+            write_streamed(key);
+    }
+
+    /**
+     * @brief Envia o conteúdo do buffer ao destino e retorna o destino atualizado.
+     */
+    Sink flush()
+    {
+        if (used > 0)
+        {
+            if constexpr (TO_STREAM)
+                sink->write(buffer.data(), static_cast<std::streamsize>(used));
+            else
+                sink = std::copy(buffer.data(), buffer.data() + used, sink);
+
+            used = 0;
+        }
+
+        return sink;
+    }
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Utilitários de linha de comando e de saída JSON compartilhados pelos benchmarks de
+// bench/ e pelas ferramentas de tools/.
+
+namespace cli
+{
+    /**
+     * @brief Separa "a,b,c" em {"a", "b", "c"}, ignorando itens vazios.
+     */
+    inline std::vector<std::string> split_list(const std::string &text)
+    {
+        std::vector<std::string> items;
+        std::stringstream stream(text);
+        std::string item;
+
+        while (std::getline(stream, item, ','))
+            if (!item.empty())
+                items.push_back(item);
+
+        return items;
+    }
+
+    /**
+     * @brief Escapa `text` para uso dentro de uma string JSON: aspas, barras invertidas e
+     * caracteres de controle (como `\n` ou `\u001f`).
+     */
+    inline std::string json_escape(const std::string &text)
+    {
+        std::string escaped;
+        escaped.reserve(text.size());
+
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\b':
+                escaped += "\\b";
+                break;
+            case '\f':
+                escaped += "\\f";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\r':
+                escaped += "\\r";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char code[7];
+                    std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(c)));
+                    escaped += code;
+                }
+                else
+                {
+                    escaped += c;
+                }
+            }
+        }
+
+        return escaped;
+    }
+}
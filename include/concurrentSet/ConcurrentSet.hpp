@@ -0,0 +1,251 @@
+#pragma once
+
+#include "set/Set.hpp"
+
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+
+/**
+ * @brief Invólucro thread-safe para `Set` baseado em um lock de leitores/escritor.
+ *
+ * Consultas (`contains`, `size`, `try_min`, ...) adquirem o `std::shared_mutex` em modo
+ * compartilhado e podem executar em paralelo; modificações (`insert`, `erase`, ...)
+ * adquirem o lock em modo exclusivo.
+ *
+ * As operações em lote (`insert_all`, `erase_all`, `contains_all`) e os métodos `read`
+ * e `write` adquirem o lock uma única vez para toda a sequência, amortizando seu custo.
+ *
+ * @tparam T Tipo dos elementos armazenados no conjunto.
+ */
+template <class T>
+class ConcurrentSet
+{
+private:
+    /**
+     * @brief O conjunto protegido pelo lock.
+     */
+    Set<T> set;
+
+    /**
+     * @brief Lock de leitores/escritor que protege `set`.
+     */
+    mutable std::shared_mutex mutex;
+
+public:
+    /**
+     * @brief Construtor padrão. Cria um conjunto vazio.
+     */
+    ConcurrentSet() = default;
+
+    /**
+     * @brief Construtor a partir de uma lista inicializadora.
+     *
+     * @param list A lista de inicialização (`std::initializer_list<T>`).
+     */
+    ConcurrentSet(std::initializer_list<T> list) : set(list) {}
+
+    ConcurrentSet(const ConcurrentSet &) = delete;
+    ConcurrentSet &operator=(const ConcurrentSet &) = delete;
+
+    /**
+     * @brief Insere uma chave no conjunto (lock exclusivo).
+     *
+     * @param key A chave a ser inserida.
+     */
+    void insert(const T &key)
+    {
+        std::unique_lock lock(mutex);
+        set.insert(key);
+    }
+
+    /**
+     * @brief Remove uma chave do conjunto (lock exclusivo).
+     *
+     * @param key A chave a ser removida.
+     */
+    void erase(const T &key)
+    {
+        std::unique_lock lock(mutex);
+        set.erase(key);
+    }
+
+    /**
+     * @brief Remove todos os elementos do conjunto (lock exclusivo).
+     */
+    void clear()
+    {
+        std::unique_lock lock(mutex);
+        set.clear();
+    }
+
+    /**
+     * @brief Verifica se o conjunto contém uma chave (lock compartilhado).
+     *
+     * @param key A chave a ser procurada.
+     * @return true Se a chave estiver presente no conjunto.
+     */
+    bool contains(const T &key) const
+    {
+        std::shared_lock lock(mutex);
+        return set.contains(key);
+    }
+
+    /**
+     * @brief Retorna o número de elementos no conjunto (lock compartilhado).
+     */
+    size_t size() const
+    {
+        std::shared_lock lock(mutex);
+        return set.size();
+    }
+
+    /**
+     * @brief Verifica se o conjunto está vazio (lock compartilhado).
+     */
+    bool empty() const
+    {
+        std::shared_lock lock(mutex);
+        return set.empty();
+    }
+
+    /**
+     * @brief Retorna o menor elemento, ou `std::nullopt` se vazio (lock compartilhado).
+     */
+    std::optional<T> try_min() const
+    {
+        std::shared_lock lock(mutex);
+        return set.try_min();
+    }
+
+    /**
+     * @brief Retorna o maior elemento, ou `std::nullopt` se vazio (lock compartilhado).
+     */
+    std::optional<T> try_max() const
+    {
+        std::shared_lock lock(mutex);
+        return set.try_max();
+    }
+
+    /**
+     * @brief Retorna o menor elemento estritamente maior que `key` (lock compartilhado).
+     */
+    std::optional<T> find_next(const T &key) const
+    {
+        std::shared_lock lock(mutex);
+        return set.find_next(key);
+    }
+
+    /**
+     * @brief Retorna o maior elemento estritamente menor que `key` (lock compartilhado).
+     */
+    std::optional<T> find_prev(const T &key) const
+    {
+        std::shared_lock lock(mutex);
+        return set.find_prev(key);
+    }
+
+    /**
+     * @brief Remove e retorna o menor elemento de forma atômica (lock exclusivo).
+     *
+     * @return std::optional<T> O elemento removido, ou `std::nullopt` se o conjunto estava vazio.
+     */
+    std::optional<T> try_pop_min()
+    {
+        std::unique_lock lock(mutex);
+        if (set.empty())
+            return std::nullopt;
+
+        return set.pop_min();
+    }
+
+    /**
+     * @brief Remove e retorna o maior elemento de forma atômica (lock exclusivo).
+     *
+     * @return std::optional<T> O elemento removido, ou `std::nullopt` se o conjunto estava vazio.
+     */
+    std::optional<T> try_pop_max()
+    {
+        std::unique_lock lock(mutex);
+        if (set.empty())
+            return std::nullopt;
+
+        return set.pop_max();
+    }
+
+    /**
+     * @brief Insere todas as chaves de `[first, last)` adquirindo o lock uma única vez.
+     */
+    template <typename Iterator>
+    void insert_all(Iterator first, Iterator last)
+    {
+        std::unique_lock lock(mutex);
+        for (; first != last; ++first)
+            set.insert(*first);
+    }
+
+    /**
+     * @brief Remove todas as chaves de `[first, last)` adquirindo o lock uma única vez.
+     */
+    template <typename Iterator>
+    void erase_all(Iterator first, Iterator last)
+    {
+        std::unique_lock lock(mutex);
+        for (; first != last; ++first)
+            set.erase(*first);
+    }
+
+    /**
+     * @brief Consulta todas as chaves de `[first, last)` sob um único lock compartilhado.
+     *
+     * Para cada chave, escreve em `out` um `bool` indicando se ela pertence ao conjunto.
+     *
+     * @return OutputIterator O iterador de saída após o último valor escrito.
+     */
+    template <typename Iterator, typename OutputIterator>
+    OutputIterator contains_all(Iterator first, Iterator last, OutputIterator out) const
+    {
+        std::shared_lock lock(mutex);
+        for (; first != last; ++first)
+            *out++ = set.contains(*first);
+
+        return out;
+    }
+
+    /**
+     * @brief Executa `f(const Set<T>&)` sob o lock compartilhado e retorna seu resultado.
+     *
+     * Útil para sequências de consultas que precisam ver um estado consistente.
+     */
+    template <typename F>
+    decltype(auto) read(F &&f) const
+    {
+        std::shared_lock lock(mutex);
+        return f(static_cast<const Set<T> &>(set));
+    }
+
+    /**
+     * @brief Executa `f(Set<T>&)` sob o lock exclusivo e retorna seu resultado.
+     *
+     * Útil para operações compostas que precisam ser atômicas.
+     */
+    template <typename F>
+    decltype(auto) write(F &&f)
+    {
+        std::unique_lock lock(mutex);
+        return f(set);
+    }
+
+    /**
+     * @brief Retorna uma cópia consistente do conjunto (lock compartilhado).
+     *
+     * A cópia compartilha a árvore (copy-on-write), então custa O(1) e pode ser lida
+     * em outra thread sem o lock enquanto o conjunto original continua sendo modificado.
+     */
+    Set<T> snapshot() const
+    {
+        std::shared_lock lock(mutex);
+        return Set<T>(set);
+    }
+};
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * @brief Domínio de recuperação de memória baseada em épocas (epoch-based reclamation).
+ *
+ * Leitores anunciam, em um slot exclusivo da sua thread, a época global vigente ao
+ * entrar em uma seção crítica (`EpochGuard`) e limpam o slot ao sair. Um escritor que
+ * desconecta nós da estrutura os "aposenta" com a época atual e avança a época global;
+ * um nó aposentado na época `e` só pode ser liberado quando todos os leitores ativos
+ * tiverem anunciado uma época maior que `e` (ver `min_active_epoch`).
+ *
+ * Cada thread ocupa um slot próprio (alinhado a uma linha de cache), então entrar e sair
+ * de uma seção crítica não disputa nenhuma linha de cache com outros leitores.
+ *
+ * Existe um único domínio global (`EpochDomain::global()`), compartilhado por todas as
+ * estruturas, de modo que uma thread usa o mesmo slot para ler qualquer uma delas.
+ */
+class EpochDomain
+{
+public:
+    /**
+     * @brief Número máximo de threads que podem estar registradas como leitoras ao mesmo tempo.
+     */
+    static constexpr size_t MAX_THREADS = 256;
+
+private:
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> epoch{0}; // 0 indica que a thread não está em uma seção crítica
+        std::atomic<bool> used{false};
+    };
+
+    struct ThreadState
+    {
+        EpochDomain *domain{nullptr};
+        int slot{-1};
+        int depth{0};
+
+        ~ThreadState()
+        {
+            if (domain != nullptr and slot >= 0)
+                domain->slots[slot].used.store(false, std::memory_order_release);
+        }
+    };
+
+    std::array<Slot, MAX_THREADS> slots;
+    alignas(64) std::atomic<uint64_t> epoch_m{1};
+
+    static ThreadState &thread_state() noexcept
+    {
+        thread_local ThreadState state;
+        return state;
+    }
+
+    int acquire_slot()
+    {
+        for (size_t i = 0; i < MAX_THREADS; i++)
+        {
+            bool expected = false;
+            if (!slots[i].used.load(std::memory_order_relaxed) and
+                slots[i].used.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+                return static_cast<int>(i);
+        }
+
+        throw std::runtime_error("Numero maximo de threads leitoras excedido");
+    }
+
+    EpochDomain() = default;
+
+public:
+    EpochDomain(const EpochDomain &) = delete;
+    EpochDomain &operator=(const EpochDomain &) = delete;
+
+    /**
+     * @brief Retorna o domínio global compartilhado.
+     */
+    static EpochDomain &global()
+    {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    /**
+     * @brief Entra em uma seção crítica de leitura. Pode ser aninhada.
+     *
+     * O anúncio da época é seguido de uma barreira sequencialmente consistente, para
+     * que nenhuma leitura da estrutura seja reordenada antes dele. A leitura da época
+     * global tem semântica de aquisição: um leitor que anuncia uma época posterior a
+     * uma aposentadoria enxerga a desconexão dos nós aposentados.
+     */
+    void enter()
+    {
+        ThreadState &state = thread_state();
+
+        if (state.depth++ > 0)
+            return;
+
+        if (state.slot < 0)
+        {
+            state.slot = acquire_slot();
+            state.domain = this;
+        }
+
+        slots[state.slot].epoch.store(epoch_m.load(std::memory_order_acquire), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Sai de uma seção crítica de leitura.
+     */
+    void exit() noexcept
+    {
+        ThreadState &state = thread_state();
+
+        if (--state.depth == 0)
+            slots[state.slot].epoch.store(0, std::memory_order_release);
+    }
+
+    /**
+     * @brief Avança a época global e retorna a época anterior.
+     *
+     * Deve ser chamada pelo escritor logo após publicar uma nova versão; o valor
+     * retornado é a marca com que os nós desconectados devem ser aposentados.
+     */
+    uint64_t advance() noexcept
+    {
+        return epoch_m.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Retorna a menor época anunciada por um leitor ativo (ou a época global, se não houver).
+     *
+     * Nós aposentados com marca estritamente menor que este valor não são mais
+     * alcançáveis por nenhum leitor e podem ser liberados. A barreira inicial pareia com
+     * a de `enter`: ou a varredura enxerga o anúncio do leitor, ou o leitor enxerga a
+     * desconexão feita antes da aposentadoria.
+     */
+    uint64_t min_active_epoch() const noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        uint64_t min = epoch_m.load(std::memory_order_seq_cst);
+
+        for (const Slot &slot : slots)
+        {
+            uint64_t e = slot.epoch.load(std::memory_order_seq_cst);
+            if (e != 0 and e < min)
+                min = e;
+        }
+
+        return min;
+    }
+};
+
+/**
+ * @brief Guarda RAII que mantém a thread atual em uma seção crítica de leitura.
+ *
+ * Enquanto o guarda existir, nenhum nó alcançável a partir de uma raiz lida dentro
+ * dele será liberado.
+ */
+class EpochGuard
+{
+private:
+    EpochDomain &domain;
+
+public:
+    explicit EpochGuard(EpochDomain &domain = EpochDomain::global()) : domain(domain)
+    {
+        domain.enter();
+    }
+
+    ~EpochGuard()
+    {
+        domain.exit();
+    }
+
+    EpochGuard(const EpochGuard &) = delete;
+    EpochGuard &operator=(const EpochGuard &) = delete;
+};
@@ -0,0 +1,604 @@
+#pragma once
+
+#include "concurrentSet/EpochReclaimer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stack>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Conjunto AVL concorrente com leitores sem lock.
+ *
+ * Os nós publicados nunca são modificados. Um escritor (serializado por um mutex)
+ * copia apenas o caminho de O(log n) nós afetados pela operação, incluindo os nós
+ * tocados por rotações, e publica a nova versão trocando atomicamente o ponteiro
+ * `root`. Leitores percorrem a árvore sem nenhum lock; apenas anunciam sua época
+ * no `EpochDomain` global, que impede a liberação dos nós que eles ainda podem ver.
+ *
+ * Os nós substituídos são aposentados com a época da publicação e liberados quando
+ * nenhum leitor ativo puder alcançá-los.
+ *
+ * @tparam T Tipo dos elementos armazenados no conjunto. Deve suportar `<` e `==`.
+ */
+template <class T>
+class EpochSet
+{
+private:
+    /**
+     * @brief Nó imutável após publicado. `version` identifica a atualização que o criou.
+     */
+    struct VersionedNode
+    {
+        T key;
+        int height;
+        VersionedNode *left;
+        VersionedNode *right;
+        uint64_t version;
+    };
+
+    using NodePtr = VersionedNode *;
+
+    /**
+     * @brief Quantidade de nós aposentados que dispara uma tentativa de liberação.
+     */
+    static constexpr size_t RECLAIM_THRESHOLD = 128;
+
+    std::atomic<NodePtr> root{nullptr};
+    std::atomic<size_t> size_m{0};
+
+    EpochDomain &domain{EpochDomain::global()};
+
+    /**
+     * @brief Serializa os escritores. Os campos abaixo só são acessados com ele adquirido.
+     */
+    std::mutex writer;
+    uint64_t version_m{0};
+    std::vector<NodePtr> pending;
+    std::vector<std::pair<uint64_t, NodePtr>> retired;
+
+    static int height(NodePtr node)
+    {
+        return (!node) ? 0 : node->height;
+    }
+
+    static int updateHeight(NodePtr node)
+    {
+        return 1 + std::max(height(node->left), height(node->right));
+    }
+
+    static int balance(NodePtr node)
+    {
+        return height(node->right) - height(node->left);
+    }
+
+    /**
+     * @brief Retorna uma versão modificável de `p` para a atualização corrente.
+     *
+     * Nós criados nesta atualização ainda não foram publicados e são devolvidos como
+     * estão; os demais são copiados e o original é marcado para aposentadoria.
+     */
+    NodePtr own(NodePtr p)
+    {
+        if (p->version == version_m)
+            return p;
+
+        NodePtr copy = new VersionedNode(*p);
+        copy->version = version_m;
+        pending.push_back(p);
+
+        return copy;
+    }
+
+    /**
+     * @brief Descarta um nó desconectado: libera-o já se nunca foi publicado, senão o aposenta.
+     */
+    void discard(NodePtr p)
+    {
+        if (p->version == version_m)
+            delete p;
+        else
+            pending.push_back(p);
+    }
+
+    NodePtr rightRotation(NodePtr p)
+    {
+        p = own(p);
+        NodePtr aux = own(p->left);
+        p->left = aux->right;
+        aux->right = p;
+
+        p->height = updateHeight(p);
+        aux->height = updateHeight(aux);
+
+        return aux;
+    }
+
+    NodePtr leftRotation(NodePtr p)
+    {
+        p = own(p);
+        NodePtr aux = own(p->right);
+        p->right = aux->left;
+        aux->left = p;
+
+        p->height = updateHeight(p);
+        aux->height = updateHeight(aux);
+
+        return aux;
+    }
+
+    NodePtr fixup_node(NodePtr p)
+    {
+        p->height = updateHeight(p);
+
+        int bal = balance(p);
+
+        if (bal == -2 and height(p->left->left) > height(p->left->right))
+            return rightRotation(p);
+        else if (bal == -2 and height(p->left->left) < height(p->left->right))
+        {
+            p->left = leftRotation(p->left);
+            return rightRotation(p);
+        }
+        else if (bal == 2 and height(p->right->right) > height(p->right->left))
+            return leftRotation(p);
+        else if (bal == 2 and height(p->right->right) < height(p->right->left))
+        {
+            p->right = rightRotation(p->right);
+            return leftRotation(p);
+        }
+
+        return p;
+    }
+
+    NodePtr fixup_deletion(NodePtr p)
+    {
+        int bal = balance(p);
+
+        if (bal == 2 and balance(p->right) >= 0)
+            return leftRotation(p);
+
+        if (bal == 2 and balance(p->right) < 0)
+        {
+            p->right = rightRotation(p->right);
+            return leftRotation(p);
+        }
+
+        if (bal == -2 and balance(p->left) <= 0)
+            return rightRotation(p);
+
+        if (bal == -2 and balance(p->left) > 0)
+        {
+            p->left = leftRotation(p->left);
+            return rightRotation(p);
+        }
+
+        p->height = updateHeight(p);
+
+        return p;
+    }
+
+    /**
+     * @brief Insere com cópia de caminho. `inserted` indica se algo mudou abaixo de `p`;
+     *        sem mudança, o nó original é devolvido intacto.
+     */
+    NodePtr insert(NodePtr p, const T &key, bool &inserted)
+    {
+        if (p == nullptr)
+        {
+            inserted = true;
+            return new VersionedNode{key, 1, nullptr, nullptr, version_m};
+        }
+
+        if (key == p->key)
+            return p;
+
+        if (key < p->key)
+        {
+            NodePtr child = insert(p->left, key, inserted);
+            if (!inserted)
+                return p;
+
+            p = own(p);
+            p->left = child;
+        }
+        else
+        {
+            NodePtr child = insert(p->right, key, inserted);
+            if (!inserted)
+                return p;
+
+            p = own(p);
+            p->right = child;
+        }
+
+        return fixup_node(p);
+    }
+
+    NodePtr remove(NodePtr p, const T &key, bool &removed)
+    {
+        if (p == nullptr)
+            return p;
+
+        if (key < p->key)
+        {
+            NodePtr child = remove(p->left, key, removed);
+            if (!removed)
+                return p;
+
+            p = own(p);
+            p->left = child;
+        }
+        else if (p->key < key)
+        {
+            NodePtr child = remove(p->right, key, removed);
+            if (!removed)
+                return p;
+
+            p = own(p);
+            p->right = child;
+        }
+        else
+        {
+            removed = true;
+
+            if (p->right == nullptr)
+            {
+                NodePtr child = p->left;
+                discard(p);
+                return child;
+            }
+
+            p = own(p);
+            p->right = remove_successor(p, p->right);
+        }
+
+        return fixup_deletion(p);
+    }
+
+    NodePtr remove_successor(NodePtr target, NodePtr node)
+    {
+        if (node->left != nullptr)
+        {
+            node = own(node);
+            node->left = remove_successor(target, node->left);
+            return fixup_deletion(node);
+        }
+
+        target->key = node->key;
+        NodePtr aux = node->right;
+        discard(node);
+
+        return aux;
+    }
+
+    /**
+     * @brief Executa uma atualização com o escritor exclusivo e publica o resultado.
+     *
+     * `f` recebe a raiz atual e devolve a nova raiz, criando nós com a versão corrente.
+     * Após a troca atômica da raiz, os nós substituídos são aposentados com a época
+     * anterior ao avanço.
+     */
+    template <typename F>
+    void update(F f)
+    {
+        std::lock_guard<std::mutex> lock(writer);
+        version_m++;
+
+        NodePtr old_root = root.load(std::memory_order_relaxed);
+        NodePtr new_root = f(old_root);
+
+        if (new_root != old_root)
+            root.store(new_root, std::memory_order_seq_cst);
+
+        if (pending.empty())
+            return;
+
+        uint64_t tag = domain.advance();
+        for (NodePtr p : pending)
+            retired.emplace_back(tag, p);
+        pending.clear();
+
+        if (retired.size() >= RECLAIM_THRESHOLD)
+            reclaim_locked();
+    }
+
+    void reclaim_locked()
+    {
+        uint64_t min = domain.min_active_epoch();
+
+        auto it = std::partition(retired.begin(), retired.end(), [min](const std::pair<uint64_t, NodePtr> &r)
+                                 { return r.first >= min; });
+
+        for (auto freed = it; freed != retired.end(); ++freed)
+            delete freed->second;
+
+        retired.erase(it, retired.end());
+    }
+
+    static void destroy(NodePtr node)
+    {
+        if (node == nullptr)
+            return;
+
+        std::stack<NodePtr> nodes;
+        nodes.push(node);
+
+        while (!nodes.empty())
+        {
+            NodePtr atual = nodes.top();
+            nodes.pop();
+
+            if (atual->left != nullptr)
+                nodes.push(atual->left);
+            if (atual->right != nullptr)
+                nodes.push(atual->right);
+
+            delete atual;
+        }
+    }
+
+public:
+    /**
+     * @brief Construtor padrão. Cria um conjunto vazio.
+     */
+    EpochSet() = default;
+
+    EpochSet(const EpochSet &) = delete;
+    EpochSet &operator=(const EpochSet &) = delete;
+
+    /**
+     * @brief Destrutor. Não pode haver leitores ou escritores concorrentes.
+     */
+    ~EpochSet()
+    {
+        destroy(root.load(std::memory_order_relaxed));
+        for (auto &r : retired)
+            delete r.second;
+    }
+
+    /**
+     * @brief Insere uma chave, publicando uma nova versão da árvore.
+     *
+     * @param key A chave a ser inserida.
+     */
+    void insert(const T &key)
+    {
+        update([this, &key](NodePtr r)
+               {
+                   bool inserted = false;
+                   r = insert(r, key, inserted);
+                   if (inserted)
+                       size_m.fetch_add(1, std::memory_order_relaxed);
+                   return r; });
+    }
+
+    /**
+     * @brief Remove uma chave, publicando uma nova versão da árvore.
+     *
+     * @param key A chave a ser removida.
+     */
+    void erase(const T &key)
+    {
+        update([this, &key](NodePtr r)
+               {
+                   bool removed = false;
+                   r = remove(r, key, removed);
+                   if (removed)
+                       size_m.fetch_sub(1, std::memory_order_relaxed);
+                   return r; });
+    }
+
+    /**
+     * @brief Insere todas as chaves de `[first, last)` em uma única versão publicada.
+     *
+     * Os nós criados pelo lote são modificados no lugar até a publicação, então o custo
+     * de cópia de caminho é pago uma vez por nó publicado, e não por chave.
+     */
+    template <typename Iterator>
+    void insert_all(Iterator first, Iterator last)
+    {
+        update([this, first, last](NodePtr r) mutable
+               {
+                   for (; first != last; ++first)
+                   {
+                       bool inserted = false;
+                       r = insert(r, *first, inserted);
+                       if (inserted)
+                           size_m.fetch_add(1, std::memory_order_relaxed);
+                   }
+                   return r; });
+    }
+
+    /**
+     * @brief Remove todas as chaves de `[first, last)` em uma única versão publicada.
+     */
+    template <typename Iterator>
+    void erase_all(Iterator first, Iterator last)
+    {
+        update([this, first, last](NodePtr r) mutable
+               {
+                   for (; first != last; ++first)
+                   {
+                       bool removed = false;
+                       r = remove(r, *first, removed);
+                       if (removed)
+                           size_m.fetch_sub(1, std::memory_order_relaxed);
+                   }
+                   return r; });
+    }
+
+    /**
+     * @brief Remove todos os elementos. Os nós antigos são aposentados, não liberados na hora.
+     */
+    void clear()
+    {
+        update([this](NodePtr r)
+               {
+                   if (r == nullptr)
+                       return r;
+
+                   std::stack<NodePtr> nodes;
+                   nodes.push(r);
+
+                   while (!nodes.empty())
+                   {
+                       NodePtr atual = nodes.top();
+                       nodes.pop();
+
+                       if (atual->left != nullptr)
+                           nodes.push(atual->left);
+                       if (atual->right != nullptr)
+                           nodes.push(atual->right);
+
+                       discard(atual);
+                   }
+
+                   size_m.store(0, std::memory_order_relaxed);
+                   return NodePtr{nullptr}; });
+    }
+
+    /**
+     * @brief Verifica se o conjunto contém uma chave, sem adquirir nenhum lock.
+     *
+     * @param key A chave a ser procurada.
+     * @return true Se a chave estiver presente na versão publicada lida.
+     */
+    bool contains(const T &key) const
+    {
+        EpochGuard guard(domain);
+        NodePtr p = root.load(std::memory_order_seq_cst);
+
+        while (p != nullptr)
+        {
+            if (key == p->key)
+                return true;
+
+            p = (key < p->key) ? p->left : p->right;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Retorna o menor elemento, ou `std::nullopt` se vazio (sem lock).
+     */
+    std::optional<T> try_min() const
+    {
+        EpochGuard guard(domain);
+        NodePtr p = root.load(std::memory_order_seq_cst);
+        if (p == nullptr)
+            return std::nullopt;
+
+        while (p->left != nullptr)
+            p = p->left;
+
+        return p->key;
+    }
+
+    /**
+     * @brief Retorna o maior elemento, ou `std::nullopt` se vazio (sem lock).
+     */
+    std::optional<T> try_max() const
+    {
+        EpochGuard guard(domain);
+        NodePtr p = root.load(std::memory_order_seq_cst);
+        if (p == nullptr)
+            return std::nullopt;
+
+        while (p->right != nullptr)
+            p = p->right;
+
+        return p->key;
+    }
+
+    /**
+     * @brief Retorna o menor elemento estritamente maior que `key` (sem lock).
+     */
+    std::optional<T> find_next(const T &key) const
+    {
+        EpochGuard guard(domain);
+        NodePtr p = root.load(std::memory_order_seq_cst);
+        NodePtr next{nullptr};
+
+        while (p != nullptr)
+        {
+            if (key < p->key)
+            {
+                next = p;
+                p = p->left;
+            }
+            else
+                p = p->right;
+        }
+
+        if (next == nullptr)
+            return std::nullopt;
+
+        return next->key;
+    }
+
+    /**
+     * @brief Retorna o maior elemento estritamente menor que `key` (sem lock).
+     */
+    std::optional<T> find_prev(const T &key) const
+    {
+        EpochGuard guard(domain);
+        NodePtr p = root.load(std::memory_order_seq_cst);
+        NodePtr prev{nullptr};
+
+        while (p != nullptr)
+        {
+            if (p->key < key)
+            {
+                prev = p;
+                p = p->right;
+            }
+            else
+                p = p->left;
+        }
+
+        if (prev == nullptr)
+            return std::nullopt;
+
+        return prev->key;
+    }
+
+    /**
+     * @brief Retorna o número de elementos da última versão publicada.
+     */
+    size_t size() const noexcept
+    {
+        return size_m.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Verifica se a versão publicada está vazia.
+     */
+    bool empty() const noexcept
+    {
+        return root.load(std::memory_order_acquire) == nullptr;
+    }
+
+    /**
+     * @brief Libera imediatamente os nós aposentados que nenhum leitor ativo pode alcançar.
+     */
+    void reclaim()
+    {
+        std::lock_guard<std::mutex> lock(writer);
+        reclaim_locked();
+    }
+
+    /**
+     * @brief Retorna quantos nós aposentados aguardam liberação.
+     */
+    size_t retired_count()
+    {
+        std::lock_guard<std::mutex> lock(writer);
+        return retired.size();
+    }
+};
@@ -0,0 +1,970 @@
+#pragma once
+
+#include "concurrentSet/EpochReclaimer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stack>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Conjunto AVL concorrente com locks por nó e buscas otimistas.
+ *
+ * Segue o algoritmo de árvore AVL de balanceamento relaxado de Bronson et al.
+ * ("A Practical Concurrent Binary Search Tree"). Cada nó possui um lock e uma versão
+ * (`version`): quem encolhe a faixa de chaves de um nó (rotação ou desconexão) marca a
+ * versão como "em mudança" e a incrementa ao terminar. Buscas não adquirem locks: descem
+ * de mão em mão, validando a versão do pai depois de ler o filho, e recomeçam do nível
+ * anterior quando a validação falha.
+ *
+ * Escritores adquirem apenas os locks dos nós que alteram, sempre de cima para baixo:
+ * - inserir uma chave nova trava somente o pai da nova folha;
+ * - remover uma chave de um nó com dois filhos apenas o marca como ausente (nó de
+ *   roteamento); nós com no máximo um filho são desconectados travando o pai e o nó;
+ * - alturas e balanceamento são corrigidos depois, subindo pela árvore, e cada rotação
+ *   trava apenas o pai, o nó e os filhos envolvidos.
+ *
+ * O balanceamento é relaxado: durante escritas concorrentes a árvore pode ficar
+ * temporariamente desbalanceada, mas toda alteração é reparada pela thread que a causou,
+ * então a árvore volta a ser AVL quando as escritas cessam.
+ *
+ * Nós desconectados são aposentados no `EpochDomain` global e só são liberados quando
+ * nenhuma operação em andamento puder alcançá-los.
+ *
+ * @tparam T Tipo dos elementos armazenados no conjunto. Deve suportar `<` e ser
+ * construtível por padrão (usado na sentinela da raiz).
+ */
+template <class T>
+class OptimisticSet
+{
+private:
+    /**
+     * @brief Bits da versão de um nó.
+     *
+     * `UNLINKED` é definitivo: o nó saiu da árvore. `CHANGING` indica que o nó está sendo
+     * rotacionado; ao terminar, a versão original é incrementada de `VERSION_STEP`.
+     */
+    static constexpr uint64_t UNLINKED = 1;
+    static constexpr uint64_t CHANGING = 2;
+    static constexpr uint64_t VERSION_STEP = 4;
+
+    /**
+     * @brief Condições retornadas por `nodeCondition`; valores positivos são a nova altura.
+     */
+    static constexpr int UNLINK_REQUIRED = -1;
+    static constexpr int REBALANCE_REQUIRED = -2;
+    static constexpr int NOTHING_REQUIRED = -3;
+
+    /**
+     * @brief Quantidade de nós aposentados que dispara uma tentativa de liberação.
+     */
+    static constexpr size_t RECLAIM_THRESHOLD = 128;
+
+    /**
+     * @brief Spinlock de um byte. Os locks são mantidos por poucas instruções, e um
+     * `std::mutex` por nó quase dobraria o tamanho do nó.
+     */
+    struct SpinLock
+    {
+        std::atomic<bool> locked{false};
+
+        void lock() noexcept
+        {
+            for (int spins = 0; locked.exchange(true, std::memory_order_acquire); spins++)
+                while (locked.load(std::memory_order_relaxed))
+                    if (++spins > 100)
+                        std::this_thread::yield();
+        }
+
+        void unlock() noexcept
+        {
+            locked.store(false, std::memory_order_release);
+        }
+    };
+
+    /**
+     * @brief Nó da árvore. A chave é imutável; os demais campos são lidos sem lock e
+     * alterados apenas com `lock` adquirido.
+     */
+    struct OptNode
+    {
+        const T key;
+        std::atomic<int> height;
+        std::atomic<bool> present;
+        SpinLock lock;
+        std::atomic<uint64_t> version{0};
+        std::atomic<OptNode *> parent;
+        std::atomic<OptNode *> left{nullptr};
+        std::atomic<OptNode *> right{nullptr};
+
+        OptNode(const T &key, int height, bool present, OptNode *parent)
+            : key(key), height(height), present(present), parent(parent) {}
+
+        std::atomic<OptNode *> &child(int dir)
+        {
+            return dir < 0 ? left : right;
+        }
+    };
+
+    using NodePtr = OptNode *;
+
+    enum class Result
+    {
+        Retry,
+        Unchanged,
+        Changed
+    };
+
+    /**
+     * @brief Sentinela cujo filho direito é a raiz da árvore.
+     */
+    NodePtr holder;
+    std::atomic<size_t> size_m{0};
+
+    EpochDomain &domain{EpochDomain::global()};
+
+    std::mutex retired_lock;
+    std::vector<std::pair<uint64_t, NodePtr>> retired;
+
+    static int compare(const T &a, const T &b)
+    {
+        return (a < b) ? -1 : ((b < a) ? 1 : 0);
+    }
+
+    static int height(NodePtr node)
+    {
+        return (!node) ? 0 : node->height.load();
+    }
+
+    static bool isShrinkingOrUnlinked(uint64_t version)
+    {
+        return (version & (CHANGING | UNLINKED)) != 0;
+    }
+
+    static bool isUnlinked(uint64_t version)
+    {
+        return version == UNLINKED;
+    }
+
+    /**
+     * @brief Espera o fim da rotação que marcou `node` com a versão `version`.
+     */
+    static void waitUntilNotChanging(NodePtr node, uint64_t version)
+    {
+        if ((version & CHANGING) == 0)
+            return;
+
+        for (int spins = 0; node->version.load() == version; spins++)
+            if (spins > 100)
+                std::this_thread::yield();
+    }
+
+    static void beginChange(NodePtr node, uint64_t version)
+    {
+        node->version.store(version | CHANGING);
+    }
+
+    static void endChange(NodePtr node, uint64_t version)
+    {
+        node->version.store(version + VERSION_STEP);
+    }
+
+    /**
+     * @brief Busca `key` abaixo de `node`, que foi alcançado com a versão `version`.
+     *
+     * @return 1 se presente, 0 se ausente, -1 se a busca precisa recomeçar no nível anterior.
+     */
+    static int attemptGet(const T &key, NodePtr node, int dir, uint64_t version)
+    {
+        while (true)
+        {
+            NodePtr child = node->child(dir).load();
+
+            if (node->version.load() != version)
+                return -1;
+
+            if (child == nullptr)
+                return 0;
+
+            int c = compare(key, child->key);
+            if (c == 0)
+                return child->present.load() ? 1 : 0;
+
+            uint64_t childVersion = child->version.load();
+            if (isShrinkingOrUnlinked(childVersion))
+            {
+                waitUntilNotChanging(child, childVersion);
+                if (node->version.load() != version)
+                    return -1;
+            }
+            else if (child != node->child(dir).load())
+            {
+                if (node->version.load() != version)
+                    return -1;
+            }
+            else
+            {
+                if (node->version.load() != version)
+                    return -1;
+
+                // O caminho até `child` foi validado; a partir daqui só a versão de
+                // `child` precisa ser verificada.
+                int result = attemptGet(key, child, c, childVersion);
+                if (result >= 0)
+                    return result;
+            }
+        }
+    }
+
+    bool attemptInsertIntoEmpty(const T &key)
+    {
+        std::lock_guard lock(holder->lock);
+
+        if (holder->right.load() != nullptr)
+            return false;
+
+        holder->right.store(new OptNode(key, 1, true, holder));
+        holder->height.store(2);
+
+        return true;
+    }
+
+    /**
+     * @brief Insere (`insert == true`) ou remove `key` abaixo de `node`.
+     */
+    Result attemptUpdate(const T &key, bool insert, NodePtr parent, NodePtr node, uint64_t version)
+    {
+        int dir = compare(key, node->key);
+        if (dir == 0)
+            return attemptNodeUpdate(insert, parent, node);
+
+        while (true)
+        {
+            NodePtr child = node->child(dir).load();
+
+            if (node->version.load() != version)
+                return Result::Retry;
+
+            if (child == nullptr)
+            {
+                if (!insert)
+                    return Result::Unchanged;
+
+                NodePtr damaged;
+                {
+                    std::lock_guard lock(node->lock);
+
+                    if (node->version.load() != version)
+                        return Result::Retry;
+
+                    if (node->child(dir).load() != nullptr)
+                        continue; // Perdeu a corrida para outra inserção
+
+                    node->child(dir).store(new OptNode(key, 1, true, node));
+                    damaged = fixHeight_nl(node);
+                }
+
+                fixHeightAndRebalance(damaged);
+                return Result::Changed;
+            }
+
+            uint64_t childVersion = child->version.load();
+            if (isShrinkingOrUnlinked(childVersion))
+                waitUntilNotChanging(child, childVersion);
+            else if (child == node->child(dir).load())
+            {
+                if (node->version.load() != version)
+                    return Result::Retry;
+
+                Result result = attemptUpdate(key, insert, node, child, childVersion);
+                if (result != Result::Retry)
+                    return result;
+            }
+        }
+    }
+
+    /**
+     * @brief Altera a presença da chave de `node`, desconectando-o se possível.
+     */
+    Result attemptNodeUpdate(bool insert, NodePtr parent, NodePtr node)
+    {
+        if (!insert and !node->present.load())
+            return Result::Unchanged;
+
+        if (!insert and (node->left.load() == nullptr or node->right.load() == nullptr))
+        {
+            NodePtr damaged;
+            {
+                std::lock_guard parentLock(parent->lock);
+
+                if (isUnlinked(parent->version.load()) or node->parent.load() != parent)
+                    return Result::Retry;
+
+                {
+                    std::lock_guard nodeLock(node->lock);
+
+                    if (!node->present.load())
+                        return Result::Unchanged;
+
+                    if (!attemptUnlink_nl(parent, node))
+                        return Result::Retry;
+                }
+
+                damaged = fixHeight_nl(parent);
+            }
+
+            fixHeightAndRebalance(damaged);
+            return Result::Changed;
+        }
+
+        std::lock_guard lock(node->lock);
+
+        if (isUnlinked(node->version.load()))
+            return Result::Retry;
+
+        if (node->present.load() == insert)
+            return Result::Unchanged;
+
+        // Se o nó perdeu um filho desde a verificação acima, ele deve ser desconectado
+        if (!insert and (node->left.load() == nullptr or node->right.load() == nullptr))
+            return Result::Retry;
+
+        node->present.store(insert);
+
+        return Result::Changed;
+    }
+
+    Result update(const T &key, bool insert)
+    {
+        while (true)
+        {
+            NodePtr right = holder->right.load();
+
+            if (right == nullptr)
+            {
+                if (!insert)
+                    return Result::Unchanged;
+                if (attemptInsertIntoEmpty(key))
+                    return Result::Changed;
+            }
+            else
+            {
+                uint64_t version = right->version.load();
+
+                if (isShrinkingOrUnlinked(version))
+                    waitUntilNotChanging(right, version);
+                else if (right == holder->right.load())
+                {
+                    Result result = attemptUpdate(key, insert, holder, right, version);
+                    if (result != Result::Retry)
+                        return result;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Desconecta `node` (com no máximo um filho) de `parent`. Ambos devem estar travados.
+     */
+    bool attemptUnlink_nl(NodePtr parent, NodePtr node)
+    {
+        NodePtr parentLeft = parent->left.load();
+        NodePtr parentRight = parent->right.load();
+        if (parentLeft != node and parentRight != node)
+            return false;
+
+        NodePtr left = node->left.load();
+        NodePtr right = node->right.load();
+        if (left != nullptr and right != nullptr)
+            return false;
+
+        NodePtr splice = (left != nullptr) ? left : right;
+
+        if (parentLeft == node)
+            parent->left.store(splice);
+        else
+            parent->right.store(splice);
+        if (splice != nullptr)
+            splice->parent.store(parent);
+
+        node->version.store(UNLINKED);
+        node->present.store(false);
+
+        retire(node);
+
+        return true;
+    }
+
+    void retire(NodePtr node)
+    {
+        uint64_t tag = domain.advance();
+
+        std::lock_guard lock(retired_lock);
+        retired.emplace_back(tag, node);
+    }
+
+    void maybe_reclaim()
+    {
+        std::unique_lock lock(retired_lock, std::try_to_lock);
+
+        if (lock.owns_lock() and retired.size() >= RECLAIM_THRESHOLD)
+            reclaim_locked();
+    }
+
+    void reclaim_locked()
+    {
+        uint64_t min = domain.min_active_epoch();
+
+        auto it = std::partition(retired.begin(), retired.end(), [min](const std::pair<uint64_t, NodePtr> &r)
+                                 { return r.first >= min; });
+
+        for (auto freed = it; freed != retired.end(); ++freed)
+            delete freed->second;
+
+        retired.erase(it, retired.end());
+    }
+
+    /**
+     * @brief Classifica o reparo que `node` precisa, com base em uma leitura sem lock.
+     *
+     * Se a leitura for inconsistente, a thread que alterou o nó é responsável por repará-lo.
+     */
+    static int nodeCondition(NodePtr node)
+    {
+        NodePtr left = node->left.load();
+        NodePtr right = node->right.load();
+
+        if ((left == nullptr or right == nullptr) and !node->present.load())
+            return UNLINK_REQUIRED;
+
+        int h = node->height.load();
+        int hL = height(left);
+        int hR = height(right);
+
+        int hRepl = 1 + std::max(hL, hR);
+        int bal = hL - hR;
+
+        if (bal < -1 or bal > 1)
+            return REBALANCE_REQUIRED;
+
+        return (h != hRepl) ? hRepl : NOTHING_REQUIRED;
+    }
+
+    /**
+     * @brief Sobe a partir de `node` reparando alturas, balanceamento e nós de roteamento.
+     */
+    void fixHeightAndRebalance(NodePtr node)
+    {
+        while (node != nullptr and node->parent.load() != nullptr)
+        {
+            int condition = nodeCondition(node);
+            if (condition == NOTHING_REQUIRED or isUnlinked(node->version.load()))
+                return;
+
+            if (condition != UNLINK_REQUIRED and condition != REBALANCE_REQUIRED)
+            {
+                std::lock_guard lock(node->lock);
+                node = fixHeight_nl(node);
+            }
+            else
+            {
+                NodePtr parent = node->parent.load();
+                std::lock_guard parentLock(parent->lock);
+
+                if (!isUnlinked(parent->version.load()) and node->parent.load() == parent)
+                {
+                    std::lock_guard nodeLock(node->lock);
+                    node = rebalance_nl(parent, node);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Corrige a altura de `node` (travado) e retorna o próximo nó a reparar, ou `nullptr`.
+     */
+    static NodePtr fixHeight_nl(NodePtr node)
+    {
+        int c = nodeCondition(node);
+
+        switch (c)
+        {
+        case REBALANCE_REQUIRED:
+        case UNLINK_REQUIRED:
+            return node;
+        case NOTHING_REQUIRED:
+            return nullptr;
+        default:
+            node->height.store(c);
+            return node->parent.load();
+        }
+    }
+
+    /**
+     * @brief Repara `node`, com `parent` e `node` travados. Retorna o próximo nó a reparar.
+     */
+    NodePtr rebalance_nl(NodePtr parent, NodePtr node)
+    {
+        NodePtr left = node->left.load();
+        NodePtr right = node->right.load();
+
+        if ((left == nullptr or right == nullptr) and !node->present.load())
+        {
+            if (attemptUnlink_nl(parent, node))
+                return fixHeight_nl(parent);
+
+            return node;
+        }
+
+        int h = node->height.load();
+        int hL = height(left);
+        int hR = height(right);
+        int hRepl = 1 + std::max(hL, hR);
+        int bal = hL - hR;
+
+        if (bal > 1)
+            return rebalanceToRight_nl(parent, node, left, hR);
+        if (bal < -1)
+            return rebalanceToLeft_nl(parent, node, right, hL);
+
+        if (hRepl != h)
+        {
+            node->height.store(hRepl);
+            return fixHeight_nl(parent);
+        }
+
+        return nullptr;
+    }
+
+    NodePtr rebalanceToRight_nl(NodePtr parent, NodePtr node, NodePtr left, int hR)
+    {
+        std::lock_guard leftLock(left->lock);
+
+        int hL = left->height.load();
+        if (hL - hR <= 1)
+            return node;
+
+        NodePtr leftRight = left->right.load();
+        int hLL = height(left->left.load());
+        int hLR = height(leftRight);
+
+        if (hLL >= hLR)
+            return rotateRight_nl(parent, node, left, hR, hLL, leftRight, hLR);
+
+        {
+            std::lock_guard leftRightLock(leftRight->lock);
+
+            hLR = leftRight->height.load();
+            if (hLL >= hLR)
+                return rotateRight_nl(parent, node, left, hR, hLL, leftRight, hLR);
+
+            int hLRL = height(leftRight->left.load());
+            int b = hLL - hLRL;
+            if (b >= -1 and b <= 1 and !((hLL == 0 or hLRL == 0) and !left->present.load()))
+                return rotateRightOverLeft_nl(parent, node, left, hR, hLL, leftRight, hLRL);
+        }
+
+        // Balanceia primeiro o filho esquerdo; `node` será reparado depois, se preciso
+        return rebalanceToLeft_nl(node, left, leftRight, hLL);
+    }
+
+    NodePtr rebalanceToLeft_nl(NodePtr parent, NodePtr node, NodePtr right, int hL)
+    {
+        std::lock_guard rightLock(right->lock);
+
+        int hR = right->height.load();
+        if (hL - hR >= -1)
+            return node;
+
+        NodePtr rightLeft = right->left.load();
+        int hRL = height(rightLeft);
+        int hRR = height(right->right.load());
+
+        if (hRR >= hRL)
+            return rotateLeft_nl(parent, node, hL, right, rightLeft, hRL, hRR);
+
+        {
+            std::lock_guard rightLeftLock(rightLeft->lock);
+
+            hRL = rightLeft->height.load();
+            if (hRR >= hRL)
+                return rotateLeft_nl(parent, node, hL, right, rightLeft, hRL, hRR);
+
+            int hRLR = height(rightLeft->right.load());
+            int b = hRR - hRLR;
+            if (b >= -1 and b <= 1 and !((hRR == 0 or hRLR == 0) and !right->present.load()))
+                return rotateLeftOverRight_nl(parent, node, hL, right, rightLeft, hRR, hRLR);
+        }
+
+        return rebalanceToRight_nl(node, right, rightLeft, hRR);
+    }
+
+    static void replaceChild(NodePtr parent, NodePtr oldChild, NodePtr newChild)
+    {
+        if (parent->left.load() == oldChild)
+            parent->left.store(newChild);
+        else
+            parent->right.store(newChild);
+
+        newChild->parent.store(parent);
+    }
+
+    NodePtr rotateRight_nl(NodePtr parent, NodePtr node, NodePtr left, int hR, int hLL, NodePtr leftRight, int hLR)
+    {
+        uint64_t nodeVersion = node->version.load();
+        uint64_t leftVersion = left->version.load();
+
+        beginChange(node, nodeVersion);
+        beginChange(left, leftVersion);
+
+        // Os ponteiros para os nós que encolhem mudam por último, para que nenhuma busca
+        // chegue a eles sem passar pela versão que indica a mudança.
+        node->left.store(leftRight);
+        if (leftRight != nullptr)
+            leftRight->parent.store(node);
+
+        left->right.store(node);
+        node->parent.store(left);
+
+        replaceChild(parent, node, left);
+
+        int hNRepl = 1 + std::max(hLR, hR);
+        node->height.store(hNRepl);
+        left->height.store(1 + std::max(hLL, hNRepl));
+
+        endChange(left, leftVersion);
+        endChange(node, nodeVersion);
+
+        int balN = hLR - hR;
+        if (balN < -1 or balN > 1)
+            return node;
+
+        if ((leftRight == nullptr or hR == 0) and !node->present.load())
+            return node;
+
+        int balL = hLL - hNRepl;
+        if (balL < -1 or balL > 1)
+            return left;
+
+        if (hLL == 0 and !left->present.load())
+            return left;
+
+        return fixHeight_nl(parent);
+    }
+
+    NodePtr rotateLeft_nl(NodePtr parent, NodePtr node, int hL, NodePtr right, NodePtr rightLeft, int hRL, int hRR)
+    {
+        uint64_t nodeVersion = node->version.load();
+        uint64_t rightVersion = right->version.load();
+
+        beginChange(node, nodeVersion);
+        beginChange(right, rightVersion);
+
+        node->right.store(rightLeft);
+        if (rightLeft != nullptr)
+            rightLeft->parent.store(node);
+
+        right->left.store(node);
+        node->parent.store(right);
+
+        replaceChild(parent, node, right);
+
+        int hNRepl = 1 + std::max(hL, hRL);
+        node->height.store(hNRepl);
+        right->height.store(1 + std::max(hNRepl, hRR));
+
+        endChange(right, rightVersion);
+        endChange(node, nodeVersion);
+
+        int balN = hRL - hL;
+        if (balN < -1 or balN > 1)
+            return node;
+
+        if ((rightLeft == nullptr or hL == 0) and !node->present.load())
+            return node;
+
+        int balR = hRR - hNRepl;
+        if (balR < -1 or balR > 1)
+            return right;
+
+        if (hRR == 0 and !right->present.load())
+            return right;
+
+        return fixHeight_nl(parent);
+    }
+
+    NodePtr rotateRightOverLeft_nl(NodePtr parent, NodePtr node, NodePtr left, int hR, int hLL, NodePtr leftRight, int hLRL)
+    {
+        uint64_t nodeVersion = node->version.load();
+        uint64_t leftVersion = left->version.load();
+        uint64_t leftRightVersion = leftRight->version.load();
+
+        NodePtr leftRightLeft = leftRight->left.load();
+        NodePtr leftRightRight = leftRight->right.load();
+        int hLRR = height(leftRightRight);
+
+        beginChange(node, nodeVersion);
+        beginChange(left, leftVersion);
+        beginChange(leftRight, leftRightVersion);
+
+        node->left.store(leftRightRight);
+        if (leftRightRight != nullptr)
+            leftRightRight->parent.store(node);
+
+        left->right.store(leftRightLeft);
+        if (leftRightLeft != nullptr)
+            leftRightLeft->parent.store(left);
+
+        leftRight->left.store(left);
+        left->parent.store(leftRight);
+        leftRight->right.store(node);
+        node->parent.store(leftRight);
+
+        replaceChild(parent, node, leftRight);
+
+        int hNRepl = 1 + std::max(hLRR, hR);
+        node->height.store(hNRepl);
+        int hLRepl = 1 + std::max(hLL, hLRL);
+        left->height.store(hLRepl);
+        leftRight->height.store(1 + std::max(hLRepl, hNRepl));
+
+        endChange(leftRight, leftRightVersion);
+        endChange(left, leftVersion);
+        endChange(node, nodeVersion);
+
+        int balN = hLRR - hR;
+        if (balN < -1 or balN > 1)
+            return node;
+
+        if ((leftRightRight == nullptr or hR == 0) and !node->present.load())
+            return node;
+
+        int balLR = hLRepl - hNRepl;
+        if (balLR < -1 or balLR > 1)
+            return leftRight;
+
+        return fixHeight_nl(parent);
+    }
+
+    NodePtr rotateLeftOverRight_nl(NodePtr parent, NodePtr node, int hL, NodePtr right, NodePtr rightLeft, int hRR, int hRLR)
+    {
+        uint64_t nodeVersion = node->version.load();
+        uint64_t rightVersion = right->version.load();
+        uint64_t rightLeftVersion = rightLeft->version.load();
+
+        NodePtr rightLeftLeft = rightLeft->left.load();
+        NodePtr rightLeftRight = rightLeft->right.load();
+        int hRLL = height(rightLeftLeft);
+
+        beginChange(node, nodeVersion);
+        beginChange(right, rightVersion);
+        beginChange(rightLeft, rightLeftVersion);
+
+        node->right.store(rightLeftLeft);
+        if (rightLeftLeft != nullptr)
+            rightLeftLeft->parent.store(node);
+
+        right->left.store(rightLeftRight);
+        if (rightLeftRight != nullptr)
+            rightLeftRight->parent.store(right);
+
+        rightLeft->right.store(right);
+        right->parent.store(rightLeft);
+        rightLeft->left.store(node);
+        node->parent.store(rightLeft);
+
+        replaceChild(parent, node, rightLeft);
+
+        int hNRepl = 1 + std::max(hL, hRLL);
+        node->height.store(hNRepl);
+        int hRRepl = 1 + std::max(hRLR, hRR);
+        right->height.store(hRRepl);
+        rightLeft->height.store(1 + std::max(hNRepl, hRRepl));
+
+        endChange(rightLeft, rightLeftVersion);
+        endChange(right, rightVersion);
+        endChange(node, nodeVersion);
+
+        int balN = hRLL - hL;
+        if (balN < -1 or balN > 1)
+            return node;
+
+        if ((rightLeftLeft == nullptr or hL == 0) and !node->present.load())
+            return node;
+
+        int balRL = hRRepl - hNRepl;
+        if (balRL < -1 or balRL > 1)
+            return rightLeft;
+
+        return fixHeight_nl(parent);
+    }
+
+    template <typename F>
+    static void inorder(NodePtr node, F &f)
+    {
+        if (node == nullptr)
+            return;
+
+        inorder(node->left.load(), f);
+        if (node->present.load())
+            f(node->key);
+        inorder(node->right.load(), f);
+    }
+
+    static void destroy(NodePtr node)
+    {
+        std::stack<NodePtr> nodes;
+        nodes.push(node);
+
+        while (!nodes.empty())
+        {
+            NodePtr atual = nodes.top();
+            nodes.pop();
+
+            if (atual->left.load() != nullptr)
+                nodes.push(atual->left.load());
+            if (atual->right.load() != nullptr)
+                nodes.push(atual->right.load());
+
+            delete atual;
+        }
+    }
+
+public:
+    /**
+     * @brief Construtor padrão. Cria um conjunto vazio.
+     */
+    OptimisticSet() : holder(new OptNode(T{}, 1, false, nullptr)) {}
+
+    OptimisticSet(const OptimisticSet &) = delete;
+    OptimisticSet &operator=(const OptimisticSet &) = delete;
+
+    /**
+     * @brief Destrutor. Não pode haver operações concorrentes.
+     */
+    ~OptimisticSet()
+    {
+        destroy(holder);
+        for (auto &r : retired)
+            delete r.second;
+    }
+
+    /**
+     * @brief Insere uma chave. Pode ser chamado por várias threads ao mesmo tempo.
+     *
+     * @param key A chave a ser inserida.
+     * @return true Se a chave não estava presente.
+     */
+    bool insert(const T &key)
+    {
+        EpochGuard guard(domain);
+
+        if (update(key, true) != Result::Changed)
+            return false;
+
+        size_m.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Remove uma chave. Pode ser chamado por várias threads ao mesmo tempo.
+     *
+     * @param key A chave a ser removida.
+     * @return true Se a chave estava presente.
+     */
+    bool erase(const T &key)
+    {
+        bool removed;
+        {
+            EpochGuard guard(domain);
+            removed = update(key, false) == Result::Changed;
+        }
+
+        if (!removed)
+            return false;
+
+        size_m.fetch_sub(1, std::memory_order_relaxed);
+        maybe_reclaim();
+        return true;
+    }
+
+    /**
+     * @brief Verifica se o conjunto contém uma chave, sem adquirir nenhum lock.
+     *
+     * @param key A chave a ser procurada.
+     * @return true Se a chave estiver presente no conjunto.
+     */
+    bool contains(const T &key) const
+    {
+        EpochGuard guard(domain);
+
+        while (true)
+        {
+            NodePtr right = holder->right.load();
+            if (right == nullptr)
+                return false;
+
+            int c = compare(key, right->key);
+            if (c == 0)
+                return right->present.load();
+
+            uint64_t version = right->version.load();
+            if (isShrinkingOrUnlinked(version))
+                waitUntilNotChanging(right, version);
+            else if (right == holder->right.load())
+            {
+                int result = attemptGet(key, right, c, version);
+                if (result >= 0)
+                    return result == 1;
+            }
+        }
+    }
+
+    /**
+     * @brief Retorna o número de elementos. Sob escritas concorrentes, o valor é aproximado.
+     */
+    size_t size() const noexcept
+    {
+        return size_m.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Chama `f(chave)` para cada elemento, em ordem crescente.
+     *
+     * A iteração é fracamente consistente: sob escritas concorrentes ela é segura, mas
+     * pode refletir apenas parte das modificações em andamento.
+     */
+    template <typename F>
+    void for_each(F f) const
+    {
+        EpochGuard guard(domain);
+        inorder(holder->right.load(), f);
+    }
+
+    /**
+     * @brief Retorna a altura da árvore. Sem escritas em andamento, é a altura de uma árvore AVL.
+     */
+    int height() const
+    {
+        EpochGuard guard(domain);
+        return height(holder->right.load());
+    }
+
+    /**
+     * @brief Libera os nós aposentados que nenhuma operação em andamento pode alcançar.
+     */
+    void reclaim()
+    {
+        std::lock_guard lock(retired_lock);
+        reclaim_locked();
+    }
+};
@@ -0,0 +1,406 @@
+#pragma once
+
+#include "set/Set.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Conjunto thread-safe particionado em faixas de chaves (shards).
+ *
+ * O espaço de chaves é dividido por chaves separadoras (`splitters`) em faixas
+ * contíguas; cada faixa é um `Set` independente com seu próprio `std::shared_mutex`.
+ * `insert`, `erase` e `contains` adquirem o lock da estrutura em modo compartilhado
+ * apenas para localizar o shard, e depois somente o lock desse shard, de modo que
+ * escritores em faixas diferentes não disputam o mesmo lock.
+ *
+ * Quando os tamanhos ficam desiguais, os shards são rebalanceados automaticamente:
+ * um shard maior que 1,5 vez o tamanho ideal (`size() / target_shards`) é dividido
+ * na mediana, e dois shards vizinhos que juntos têm menos da metade do tamanho ideal
+ * são unidos. O rebalanceamento adquire o lock da estrutura em modo exclusivo e monta
+ * os novos shards a partir das chaves já ordenadas, em tempo linear.
+ *
+ * Iteração ordenada, `minimum` e `maximum` percorrem os shards em ordem de faixa.
+ *
+ * @tparam T Tipo dos elementos armazenados no conjunto. Deve suportar `<` e `==`.
+ */
+template <class T>
+class ShardedSet
+{
+private:
+    /**
+     * @brief Tamanho abaixo do qual um shard nunca é dividido.
+     */
+    static constexpr size_t MIN_SHARD_SIZE = 1024;
+
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        Set<T> set;
+    };
+
+    /**
+     * @brief Protege `splitters` e `shards`. Modo exclusivo apenas para rebalancear.
+     *
+     * O shard `i` contém as chaves `k` com `splitters[i - 1] <= k < splitters[i]`.
+     */
+    mutable std::shared_mutex layout;
+    std::vector<T> splitters;
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    size_t target_shards;
+    std::atomic<size_t> size_m{0};
+    std::atomic<bool> rebalance_pending{false};
+
+    size_t route(const T &key) const
+    {
+        return std::upper_bound(splitters.begin(), splitters.end(), key) - splitters.begin();
+    }
+
+    size_t ideal_size() const noexcept
+    {
+        return size_m.load(std::memory_order_relaxed) / target_shards;
+    }
+
+    bool should_split(size_t shard_size) const noexcept
+    {
+        return shard_size >= 2 * MIN_SHARD_SIZE and 2 * shard_size > 3 * ideal_size();
+    }
+
+    bool should_merge(size_t pair_size) const noexcept
+    {
+        return 2 * pair_size < ideal_size();
+    }
+
+    /**
+     * @brief Chaves do shard `i` em ordem, acrescentadas ao fim de `keys`.
+     */
+    void collect(size_t i, std::vector<T> &keys) const
+    {
+        shards[i]->set.for_each([&keys](const T &key)
+                                { keys.push_back(key); });
+    }
+
+    /**
+     * @brief Shard com as chaves ordenadas de `[first, last)`, montado em O(n) sem rotações.
+     */
+    static std::unique_ptr<Shard> build(typename std::vector<T>::const_iterator first, typename std::vector<T>::const_iterator last)
+    {
+        auto shard = std::make_unique<Shard>();
+        Set<T> built = Set<T>::from_sorted(std::vector<T>(first, last));
+        shard->set.swap(built);
+
+        return shard;
+    }
+
+    /**
+     * @brief Divide o shard `i` na mediana. Requer o lock exclusivo de `layout`.
+     */
+    void split(size_t i)
+    {
+        std::vector<T> keys;
+        keys.reserve(shards[i]->set.size());
+        collect(i, keys);
+
+        size_t middle = keys.size() / 2;
+
+        auto left = build(keys.begin(), keys.begin() + middle);
+        auto right = build(keys.begin() + middle, keys.end());
+
+        // Reserva antes de alterar, para que uma falha de alocação não deixe as faixas inconsistentes
+        splitters.reserve(splitters.size() + 1);
+        shards.reserve(shards.size() + 1);
+
+        splitters.insert(splitters.begin() + i, keys[middle]);
+        shards[i] = std::move(left);
+        shards.insert(shards.begin() + i + 1, std::move(right));
+    }
+
+    /**
+     * @brief Une os shards `i` e `i + 1`. Requer o lock exclusivo de `layout`.
+     */
+    void merge(size_t i)
+    {
+        // As chaves do shard `i` são todas menores que as do shard `i + 1`
+        std::vector<T> keys;
+        keys.reserve(shards[i]->set.size() + shards[i + 1]->set.size());
+        collect(i, keys);
+        collect(i + 1, keys);
+
+        shards[i] = build(keys.begin(), keys.end());
+        shards.erase(shards.begin() + i + 1);
+        splitters.erase(splitters.begin() + i);
+    }
+
+    void rebalance_locked()
+    {
+        for (size_t i = 0; i + 1 < shards.size();)
+        {
+            if (should_merge(shards[i]->set.size() + shards[i + 1]->set.size()))
+                merge(i);
+            else
+                i++;
+        }
+
+        for (size_t i = 0; i < shards.size();)
+        {
+            if (should_split(shards[i]->set.size()))
+                split(i);
+            else
+                i++;
+        }
+    }
+
+public:
+    /**
+     * @brief Cria um conjunto vazio que tende a se dividir em `target_shards` faixas.
+     *
+     * @param target_shards Número desejado de shards; normalmente o número de threads escritoras.
+     */
+    explicit ShardedSet(size_t target_shards = std::thread::hardware_concurrency())
+        : target_shards(std::max<size_t>(target_shards, 1))
+    {
+        shards.push_back(std::make_unique<Shard>());
+    }
+
+    ShardedSet(const ShardedSet &) = delete;
+    ShardedSet &operator=(const ShardedSet &) = delete;
+
+    /**
+     * @brief Insere uma chave, travando apenas o shard da sua faixa.
+     *
+     * @param key A chave a ser inserida.
+     */
+    void insert(const T &key)
+    {
+        bool unbalanced = false;
+        {
+            std::shared_lock layout_lock(layout);
+            Shard &shard = *shards[route(key)];
+            std::unique_lock lock(shard.mutex);
+
+            size_t old_size = shard.set.size();
+            shard.set.insert(key);
+
+            if (shard.set.size() != old_size)
+            {
+                size_m.fetch_add(1, std::memory_order_relaxed);
+                unbalanced = should_split(shard.set.size());
+            }
+        }
+
+        if (unbalanced)
+            rebalance();
+    }
+
+    /**
+     * @brief Remove uma chave, travando apenas o shard da sua faixa.
+     *
+     * @param key A chave a ser removida.
+     */
+    void erase(const T &key)
+    {
+        bool unbalanced = false;
+        {
+            std::shared_lock layout_lock(layout);
+            Shard &shard = *shards[route(key)];
+            std::unique_lock lock(shard.mutex);
+
+            size_t old_size = shard.set.size();
+            shard.set.erase(key);
+
+            if (shard.set.size() != old_size)
+            {
+                size_m.fetch_sub(1, std::memory_order_relaxed);
+                // Só no momento em que o shard fica pequeno, para não rebalancear a cada remoção
+                size_t quarter = ideal_size() / 4;
+                unbalanced = shards.size() > 1 and shard.set.size() + 1 == quarter;
+            }
+        }
+
+        if (unbalanced)
+            rebalance();
+    }
+
+    /**
+     * @brief Verifica se o conjunto contém uma chave (locks compartilhados).
+     */
+    bool contains(const T &key) const
+    {
+        std::shared_lock layout_lock(layout);
+        const Shard &shard = *shards[route(key)];
+        std::shared_lock lock(shard.mutex);
+
+        return shard.set.contains(key);
+    }
+
+    /**
+     * @brief Retorna o número de elementos. Sob escritas concorrentes, o valor é aproximado.
+     */
+    size_t size() const noexcept
+    {
+        return size_m.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Remove todos os elementos e volta a ter um único shard.
+     */
+    void clear()
+    {
+        std::unique_lock layout_lock(layout);
+
+        shards.clear();
+        shards.push_back(std::make_unique<Shard>());
+        splitters.clear();
+        size_m.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Retorna o menor elemento, ou `std::nullopt` se vazio.
+     */
+    std::optional<T> try_min() const
+    {
+        std::shared_lock layout_lock(layout);
+
+        for (const auto &shard : shards)
+        {
+            std::shared_lock lock(shard->mutex);
+            if (!shard->set.empty())
+                return shard->set.try_min();
+        }
+
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Retorna o maior elemento, ou `std::nullopt` se vazio.
+     */
+    std::optional<T> try_max() const
+    {
+        std::shared_lock layout_lock(layout);
+
+        for (auto it = shards.rbegin(); it != shards.rend(); ++it)
+        {
+            std::shared_lock lock((*it)->mutex);
+            if (!(*it)->set.empty())
+                return (*it)->set.try_max();
+        }
+
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Retorna o menor elemento do conjunto.
+     *
+     * @throw std::runtime_error Se o conjunto estiver vazio.
+     */
+    T minimum() const
+    {
+        std::optional<T> min = try_min();
+        if (!min)
+            throw std::runtime_error("Nao ha elementos no Set");
+
+        return *min;
+    }
+
+    /**
+     * @brief Retorna o maior elemento do conjunto.
+     *
+     * @throw std::runtime_error Se o conjunto estiver vazio.
+     */
+    T maximum() const
+    {
+        std::optional<T> max = try_max();
+        if (!max)
+            throw std::runtime_error("Nao ha elementos no Set");
+
+        return *max;
+    }
+
+    /**
+     * @brief Chama `f(chave)` para cada elemento, em ordem crescente.
+     *
+     * Cada shard é copiado em O(1) sob seu lock e percorrido sem nenhum lock, então `f`
+     * pode chamar métodos deste conjunto. Cada shard é visto em um estado consistente,
+     * mas shards diferentes podem ser vistos em momentos diferentes.
+     */
+    template <typename F>
+    void for_each(F f) const
+    {
+        std::vector<Set<T>> snapshots;
+        {
+            std::shared_lock layout_lock(layout);
+            snapshots.reserve(shards.size());
+
+            for (const auto &shard : shards)
+            {
+                std::shared_lock lock(shard->mutex);
+                snapshots.emplace_back(shard->set);
+            }
+        }
+
+        for (const Set<T> &snapshot : snapshots)
+            snapshot.for_each(f);
+    }
+
+    /**
+     * @brief Divide e une shards até que nenhum esteja fora da faixa de tamanho aceitável.
+     *
+     * É chamado automaticamente por `insert` e `erase`; se outra thread já estiver
+     * rebalanceando, retorna imediatamente.
+     */
+    void rebalance()
+    {
+        if (rebalance_pending.exchange(true, std::memory_order_acquire))
+            return;
+
+        // Libera a marca também se `split` ou `merge` lançarem (falta de memória, por
+        // exemplo); do contrário nenhum rebalanceamento voltaria a acontecer
+        struct PendingGuard
+        {
+            std::atomic<bool> &pending;
+            ~PendingGuard() { pending.store(false, std::memory_order_release); }
+        } guard{rebalance_pending};
+
+        std::unique_lock layout_lock(layout);
+        rebalance_locked();
+    }
+
+    /**
+     * @brief Retorna o número atual de shards.
+     */
+    size_t shard_count() const
+    {
+        std::shared_lock layout_lock(layout);
+        return shards.size();
+    }
+
+    /**
+     * @brief Retorna o número de elementos de cada shard, em ordem de faixa.
+     */
+    std::vector<size_t> shard_sizes() const
+    {
+        std::shared_lock layout_lock(layout);
+        std::vector<size_t> sizes;
+
+        for (const auto &shard : shards)
+        {
+            std::shared_lock lock(shard->mutex);
+            sizes.push_back(shard->set.size());
+        }
+
+        return sizes;
+    }
+};
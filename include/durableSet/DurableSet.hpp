@@ -0,0 +1,510 @@
+#pragma once
+
+#include "set/Set.hpp"
+#include "serialization/Serialization.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define DURABLE_SET_HAS_FSYNC 1
+#else
+#define DURABLE_SET_HAS_FSYNC 0
+#endif
+
+/**
+ * @brief Parâmetros de durabilidade de um `DurableSet`.
+ */
+struct DurableOptions
+{
+    /**
+     * @brief Número de registros pendentes que dispara a gravação e o fsync do log.
+     */
+    size_t group_commit_records{64};
+
+    /**
+     * @brief Tempo máximo que um registro fica pendente antes de ser gravado, verificado
+     * a cada modificação (sem modificações, use `sync()`).
+     */
+    std::chrono::milliseconds group_commit_delay{5};
+
+    /**
+     * @brief Tamanho do log, em bytes, a partir do qual um checkpoint é feito automaticamente.
+     * Com 0, checkpoints só acontecem por `checkpoint()`.
+     */
+    uint64_t checkpoint_log_bytes{16u << 20};
+};
+
+/**
+ * @brief `Set` com log de escrita antecipada (write-ahead log) e recuperação após falhas.
+ *
+ * Cada `insert`/`erase` que altera o conjunto gera um registro no arquivo `wal` do
+ * diretório, com o tamanho, o CRC-32 e o conteúdo (operação e chave codificada por
+ * `KeyCodec<T>`). Os registros são acumulados e gravados com um único fsync a cada
+ * `group_commit_records` registros ou `group_commit_delay` (group commit); `sync()`
+ * força a gravação. Em caso de falha, perdem-se no máximo os registros ainda pendentes.
+ *
+ * `checkpoint()` grava o conjunto em `checkpoint` com `Set::save` (arquivo temporário
+ * renomeado atomicamente) e trunca o log. Ao abrir o diretório, o conjunto é montado a
+ * partir do último checkpoint e dos registros do log; um registro final incompleto ou
+ * com CRC inválido (escrita interrompida) é descartado. Como reaplicar inserções e
+ * remoções em ordem é idempotente, uma falha entre o checkpoint e o truncamento do log
+ * não altera o resultado.
+ *
+ * Assim como `Set`, não deve ser modificado concorrentemente.
+ *
+ * @tparam T Tipo dos elementos armazenados no conjunto. Deve ter um `KeyCodec<T>`.
+ */
+template <class T>
+class DurableSet
+{
+private:
+    static constexpr char MAGIC[8] = {'A', 'V', 'L', 'W', 'A', 'L', '\0', '\1'};
+    static constexpr uint64_t HEADER_SIZE = sizeof(MAGIC) + 2 * sizeof(uint32_t);
+
+    enum Operation : uint8_t
+    {
+        Insert = 1,
+        Erase = 2,
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    std::filesystem::path directory;
+    DurableOptions options;
+    Set<T> set;
+
+    std::FILE *log{nullptr};
+    uint64_t log_bytes{0};
+    bool log_damaged{false}; // Uma escrita parcial não pôde ser desfeita
+
+    std::string pending;
+    size_t pending_records{0};
+    Clock::time_point oldest_pending{};
+
+    std::filesystem::path log_path() const
+    {
+        return directory / "wal";
+    }
+
+    std::filesystem::path checkpoint_path() const
+    {
+        return directory / "checkpoint";
+    }
+
+    static void fsync_file(std::FILE *file)
+    {
+#if DURABLE_SET_HAS_FSYNC
+        if (::fsync(::fileno(file)) != 0)
+            throw std::runtime_error("Falha ao sincronizar o log do DurableSet");
+#else
+        (void)file;
+#endif
+    }
+
+    /**
+     * @brief Abre o log sem o buffer do stdio: cada `sync` já grava tudo com um único
+     * `fwrite`, e sem buffer uma escrita que falha não deixa bytes para o próximo flush.
+     */
+    static std::FILE *open_file(const std::filesystem::path &path, const char *mode)
+    {
+        std::FILE *file = std::fopen(path.string().c_str(), mode);
+        if (file == nullptr)
+            throw std::runtime_error("Nao foi possivel abrir o arquivo: " + path.string());
+
+        std::setvbuf(file, nullptr, _IONBF, 0);
+        return file;
+    }
+
+    static void fsync_path(const std::filesystem::path &path)
+    {
+#if DURABLE_SET_HAS_FSYNC
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Nao foi possivel abrir o arquivo: " + path.string());
+
+        int result = ::fsync(fd);
+        ::close(fd);
+        if (result != 0)
+            throw std::runtime_error("Falha ao sincronizar o arquivo: " + path.string());
+#else
+        (void)path;
+#endif
+    }
+
+    static void put_u32(std::string &out, uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+            out.push_back(static_cast<char>(value >> (8 * i)));
+    }
+
+    static uint32_t get_u32(const char *in)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++)
+            value |= static_cast<uint32_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+        return value;
+    }
+
+    static void encode_key(std::string &out, const T &key)
+    {
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            out.append(reinterpret_cast<const char *>(&key), sizeof(T));
+        }
+        else
+        {
+            std::ostringstream buffer(std::ios::binary);
+            BinaryWriter writer(&buffer);
+            KeyCodec<T>::encode(writer, key);
+            writer.flush();
+            out += buffer.str();
+        }
+    }
+
+    static T decode_key(const char *data, size_t size)
+    {
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (size != sizeof(T))
+                throw std::runtime_error("Registro do log com tamanho invalido");
+
+            T key;
+            std::memcpy(&key, data, sizeof(T));
+            return key;
+        }
+        else
+        {
+            std::istringstream buffer(std::string(data, size), std::ios::binary);
+            BinaryReader reader(buffer);
+            return KeyCodec<T>::decode(reader);
+        }
+    }
+
+    /**
+     * @brief Reaplica os registros válidos do log e retorna o tamanho do prefixo válido.
+     */
+    uint64_t replay()
+    {
+        std::ifstream in(log_path(), std::ios::binary);
+        if (!in)
+            return 0;
+
+        char header[HEADER_SIZE];
+        if (!in.read(header, HEADER_SIZE))
+            return 0; // Log criado mas interrompido antes do cabeçalho
+
+        if (std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0)
+            throw std::runtime_error("Arquivo nao contem um log de DurableSet: " + log_path().string());
+        if (get_u32(header + sizeof(MAGIC)) != KeyCodec<T>::TYPE_TAG)
+            throw std::runtime_error("Tipo das chaves do log nao corresponde ao DurableSet");
+
+        uint64_t valid = HEADER_SIZE;
+        uint64_t file_size = std::filesystem::file_size(log_path());
+        std::string body;
+
+        for (;;)
+        {
+            char prefix[8];
+            if (!in.read(prefix, sizeof(prefix)))
+                break;
+
+            uint32_t size = get_u32(prefix);
+            uint32_t crc = get_u32(prefix + 4);
+            if (size == 0 or size > file_size - valid - sizeof(prefix))
+                break;
+
+            body.resize(size);
+            if (!in.read(body.data(), size))
+                break;
+
+            Crc32 check;
+            check.update(body.data(), body.size());
+            if (check.value() != crc)
+                break;
+
+            T key = decode_key(body.data() + 1, body.size() - 1);
+            if (body[0] == Insert)
+                set.insert(key);
+            else if (body[0] == Erase)
+                set.erase(key);
+            else
+                break;
+
+            valid += sizeof(prefix) + size;
+        }
+
+        return valid;
+    }
+
+    /**
+     * @brief Cria um log vazio (só o cabeçalho) em `wal.tmp`, sincronizado, e o coloca no
+     * lugar de `wal` com um rename. Retorna o arquivo aberto, pronto para acrescentar registros.
+     *
+     * Se algo falhar antes do rename, o log atual não é tocado e o temporário é removido.
+     */
+    std::FILE *create_log()
+    {
+        std::filesystem::path temporary = directory / "wal.tmp";
+        std::FILE *file = open_file(temporary, "wb");
+
+        try
+        {
+            std::string header(MAGIC, sizeof(MAGIC));
+            put_u32(header, KeyCodec<T>::TYPE_TAG);
+            put_u32(header, 0);
+            if (std::fwrite(header.data(), 1, header.size(), file) != header.size() or std::fflush(file) != 0)
+                throw std::runtime_error("Falha ao gravar o log do DurableSet");
+
+            fsync_file(file);
+            std::filesystem::rename(temporary, log_path());
+        }
+        catch (...)
+        {
+            std::fclose(file);
+            std::error_code error;
+            std::filesystem::remove(temporary, error);
+            throw;
+        }
+
+        return file;
+    }
+
+    void open_log(uint64_t valid)
+    {
+        std::filesystem::path path = log_path();
+
+        if (valid < HEADER_SIZE)
+        {
+            log = create_log();
+            log_bytes = HEADER_SIZE;
+            fsync_path(directory);
+            return;
+        }
+
+        if (std::filesystem::file_size(path) != valid)
+        {
+            std::filesystem::resize_file(path, valid);
+            fsync_path(path);
+        }
+
+        log = open_file(path, "ab");
+
+        log_bytes = valid;
+    }
+
+    /**
+     * @brief Corta do log o que uma escrita que falhou chegou a gravar, para que uma nova
+     * tentativa de `sync` grave os registros pendentes logo após o último registro válido.
+     * Sem isso a nova tentativa ficaria depois de um registro pela metade, e o replay
+     * descartaria tudo a partir dele. Se nem o corte for possível, o log passa a recusar escritas.
+     */
+    void discard_partial_write() noexcept
+    {
+        std::error_code error;
+        std::filesystem::resize_file(log_path(), log_bytes, error);
+        std::clearerr(log);
+
+        if (error or std::fseek(log, static_cast<long>(log_bytes), SEEK_SET) != 0)
+            log_damaged = true;
+    }
+
+    void append(Operation op, const T &key)
+    {
+        size_t start = pending.size();
+        pending.append(8, '\0');
+        pending.push_back(static_cast<char>(op));
+        encode_key(pending, key);
+
+        size_t size = pending.size() - start - 8;
+        Crc32 crc;
+        crc.update(pending.data() + start + 8, size);
+
+        std::string prefix;
+        put_u32(prefix, static_cast<uint32_t>(size));
+        put_u32(prefix, crc.value());
+        pending.replace(start, 8, prefix);
+
+        if (pending_records++ == 0)
+            oldest_pending = Clock::now();
+
+        if (pending_records >= options.group_commit_records or Clock::now() - oldest_pending >= options.group_commit_delay)
+        {
+            sync();
+
+            if (options.checkpoint_log_bytes != 0 and log_bytes >= options.checkpoint_log_bytes)
+                checkpoint();
+        }
+    }
+
+public:
+    /**
+     * @brief Abre (ou cria) o conjunto durável no diretório `directory`, recuperando o
+     * último checkpoint e reaplicando o log.
+     *
+     * @throw std::runtime_error Se os arquivos existentes forem inválidos ou não puderem ser abertos.
+     */
+    explicit DurableSet(const std::string &directory, DurableOptions options = {})
+        : directory(directory), options(options)
+    {
+        std::filesystem::create_directories(this->directory);
+        std::filesystem::remove(this->directory / "checkpoint.tmp");
+
+        if (std::filesystem::exists(checkpoint_path()))
+            set.load(checkpoint_path().string());
+
+        open_log(replay());
+    }
+
+    DurableSet(const DurableSet &) = delete;
+    DurableSet &operator=(const DurableSet &) = delete;
+
+    /**
+     * @brief Grava os registros pendentes e fecha o log.
+     */
+    ~DurableSet()
+    {
+        try
+        {
+            sync();
+        }
+        catch (const std::exception &)
+        {
+            // Os registros pendentes se perdem, como em uma falha
+        }
+
+        if (log != nullptr)
+            std::fclose(log);
+    }
+
+    /**
+     * @brief Insere uma chave, registrando a operação no log se o conjunto mudar.
+     */
+    void insert(const T &key)
+    {
+        size_t old_size = set.size();
+        set.insert(key);
+
+        if (set.size() != old_size)
+            append(Insert, key);
+    }
+
+    /**
+     * @brief Remove uma chave, registrando a operação no log se o conjunto mudar.
+     */
+    void erase(const T &key)
+    {
+        size_t old_size = set.size();
+        set.erase(key);
+
+        if (set.size() != old_size)
+            append(Erase, key);
+    }
+
+    bool contains(const T &key) const
+    {
+        return set.contains(key);
+    }
+
+    size_t size() const noexcept
+    {
+        return set.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return set.empty();
+    }
+
+    /**
+     * @brief Acesso somente leitura ao conjunto em memória.
+     */
+    const Set<T> &view() const noexcept
+    {
+        return set;
+    }
+
+    /**
+     * @brief Grava os registros pendentes no log com um único fsync.
+     *
+     * Se a escrita falhar, o log volta ao tamanho anterior e os registros continuam
+     * pendentes para a próxima chamada.
+     *
+     * @throw std::runtime_error Se a escrita ou o fsync falharem.
+     */
+    void sync()
+    {
+        if (log_damaged or log == nullptr)
+            throw std::runtime_error("Log do DurableSet inconsistente apos falha de escrita");
+
+        if (pending.empty())
+            return;
+
+        try
+        {
+            if (std::fwrite(pending.data(), 1, pending.size(), log) != pending.size() or std::fflush(log) != 0)
+                throw std::runtime_error("Falha ao gravar o log do DurableSet");
+            fsync_file(log);
+        }
+        catch (const std::runtime_error &)
+        {
+            discard_partial_write();
+            throw;
+        }
+
+        log_bytes += pending.size();
+        pending.clear();
+        pending_records = 0;
+    }
+
+    /**
+     * @brief Grava o conjunto inteiro em `checkpoint` e trunca o log.
+     *
+     * @throw std::runtime_error Se a escrita falhar; nesse caso o checkpoint anterior e o log continuam válidos.
+     */
+    void checkpoint()
+    {
+        sync();
+
+        std::filesystem::path temporary = directory / "checkpoint.tmp";
+        set.save(temporary.string());
+        fsync_path(temporary);
+        std::filesystem::rename(temporary, checkpoint_path());
+        fsync_path(directory);
+
+        // O log antigo só é fechado depois que o novo já está no lugar dele
+        std::FILE *fresh = create_log();
+        std::fclose(log);
+        log = fresh;
+        log_bytes = HEADER_SIZE;
+        fsync_path(directory);
+    }
+
+    /**
+     * @brief Número de registros ainda não gravados no log.
+     */
+    size_t pending_count() const noexcept
+    {
+        return pending_records;
+    }
+
+    /**
+     * @brief Tamanho atual do log em disco, em bytes.
+     */
+    uint64_t log_size() const noexcept
+    {
+        return log_bytes;
+    }
+};
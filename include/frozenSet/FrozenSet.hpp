@@ -0,0 +1,471 @@
+#pragma once
+
+#include "set/Set.hpp"
+#include "serialization/Serialization.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FROZEN_SET_HAS_MMAP 1
+#else
+#define FROZEN_SET_HAS_MMAP 0
+#endif
+
+/**
+ * @brief Cabeçalho do formato em disco de `FrozenSet` (ocupa os primeiros 64 bytes).
+ */
+struct FrozenSetHeader
+{
+    static constexpr char MAGIC[8] = {'A', 'V', 'L', 'F', 'R', 'Z', '\0', '\1'};
+    static constexpr uint64_t KEYS_OFFSET = 64;
+
+    char magic[8];
+    uint32_t type_tag; // Ver `KeyCodec<T>::TYPE_TAG`
+    uint32_t key_size; // sizeof(T)
+    uint64_t count;    // Número de chaves
+    uint64_t keys_offset;
+};
+
+/**
+ * @brief Conjunto imutável em layout contíguo, que pode ser mapeado do disco e consultado no lugar.
+ *
+ * As chaves ficam em um único vetor na ordem de Eytzinger (a ordem de uma busca em
+ * largura da árvore binária completa): a raiz está na posição 1 e os filhos da posição
+ * `k` nas posições `2k` e `2k + 1`. Não há ponteiros, apenas índices, então o arquivo
+ * gravado por `write` independe do endereço em que é carregado.
+ *
+ * `open` mapeia o arquivo somente para leitura (`mmap`) e não desserializa nada: abrir
+ * custa O(1) e cada consulta só toca as páginas necessárias, que ficam no cache de páginas
+ * do sistema e são compartilhadas entre processos. Apenas o cabeçalho é validado; o
+ * conteúdo não é verificado ao abrir. Sem `mmap` (fora de sistemas POSIX), o arquivo é
+ * lido inteiro para a memória.
+ *
+ * A busca percorre o vetor de cima para baixo sem desvios dependentes de dados e os
+ * quatro níveis seguintes de uma busca ocupam posições contíguas, o que permite
+ * pré-carregá-los.
+ *
+ * @tparam T Tipo das chaves; deve ser trivialmente copiável e suportar `<`. A ordem de
+ * bytes é a nativa da máquina.
+ */
+template <class T>
+class FrozenSet
+{
+    static_assert(std::is_trivially_copyable_v<T>, "FrozenSet requer chaves trivialmente copiaveis");
+
+private:
+    /**
+     * @brief Chaves em ordem de Eytzinger; `keys[0]` não é usada.
+     */
+    const T *keys{nullptr};
+    size_t count{0};
+
+    void *mapping{nullptr};
+    size_t mapping_size{0};
+    T *owned{nullptr};
+
+    static constexpr std::align_val_t ALIGNMENT{64};
+
+    static T *allocate(size_t slots)
+    {
+        return static_cast<T *>(::operator new(slots * sizeof(T), ALIGNMENT));
+    }
+
+    void release() noexcept
+    {
+#if FROZEN_SET_HAS_MMAP
+        if (mapping != nullptr)
+            munmap(mapping, mapping_size);
+#endif
+        if (owned != nullptr)
+            ::operator delete(owned, ALIGNMENT);
+
+        keys = owned = nullptr;
+        mapping = nullptr;
+        count = mapping_size = 0;
+    }
+
+    /**
+     * @brief Copia as chaves ordenadas `sorted` para `out` (com `count + 1` posições) na ordem de Eytzinger.
+     */
+    static size_t eytzinger(const std::vector<T> &sorted, T *out, size_t i, size_t k)
+    {
+        if (k <= sorted.size())
+        {
+            i = eytzinger(sorted, out, i, 2 * k);
+            out[k] = sorted[i++];
+            i = eytzinger(sorted, out, i, 2 * k + 1);
+        }
+
+        return i;
+    }
+
+    static std::vector<T> sorted_keys(const Set<T> &set)
+    {
+        std::vector<T> sorted;
+        sorted.reserve(set.size());
+        set.for_each([&sorted](const T &key)
+                     { sorted.push_back(key); });
+
+        return sorted;
+    }
+
+    static void validate(const FrozenSetHeader &header, size_t file_size)
+    {
+        if (std::memcmp(header.magic, FrozenSetHeader::MAGIC, sizeof(header.magic)) != 0)
+            throw std::runtime_error("Arquivo nao contem um FrozenSet");
+
+        if (header.type_tag != KeyCodec<T>::TYPE_TAG or header.key_size != sizeof(T))
+            throw std::runtime_error("Tipo das chaves do arquivo nao corresponde ao FrozenSet");
+
+        if (header.keys_offset % alignof(T) != 0 or header.keys_offset < sizeof(FrozenSetHeader) or
+            header.count > (file_size - std::min<uint64_t>(file_size, header.keys_offset)) / sizeof(T) or
+            header.keys_offset + (header.count + 1) * sizeof(T) > file_size)
+            throw std::runtime_error("Arquivo de FrozenSet truncado");
+    }
+
+    /**
+     * @brief Índice de Eytzinger da menor chave `>= key`, ou 0 se não houver.
+     */
+    size_t lower_bound_index(const T &key) const noexcept
+    {
+        size_t k = 1;
+
+        while (k <= count)
+        {
+#if defined(__GNUC__)
+            __builtin_prefetch(keys + 16 * k);
+#endif
+            k = 2 * k + (keys[k] < key);
+        }
+
+        // Desfaz os passos à direita do final da busca; o último passo à esquerda leva à resposta
+        return k >> (std::countr_one(k) + 1);
+    }
+
+public:
+    /**
+     * @brief Iterador constante em ordem crescente.
+     */
+    class const_iterator
+    {
+    private:
+        const T *keys{nullptr};
+        size_t count{0};
+        size_t k{0}; // 0 indica o fim
+
+        friend class FrozenSet;
+
+        const_iterator(const T *keys, size_t count, size_t k) : keys(keys), count(count), k(k) {}
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() = default;
+
+        reference operator*() const
+        {
+            return keys[k];
+        }
+
+        pointer operator->() const
+        {
+            return keys + k;
+        }
+
+        const_iterator &operator++()
+        {
+            if (2 * k + 1 <= count)
+            {
+                // Menor chave da subárvore direita
+                k = 2 * k + 1;
+                while (2 * k <= count)
+                    k = 2 * k;
+            }
+            else
+            {
+                // Sobe enquanto vier de um filho direito; depois sobe mais uma vez
+                k >>= std::countr_one(k) + 1;
+            }
+
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const const_iterator &other) const
+        {
+            return k == other.k;
+        }
+
+        bool operator!=(const const_iterator &other) const
+        {
+            return k != other.k;
+        }
+    };
+
+    /**
+     * @brief Cria um conjunto congelado vazio.
+     */
+    FrozenSet() = default;
+
+    /**
+     * @brief Cria, em memória, um conjunto congelado com as chaves de `set`.
+     */
+    explicit FrozenSet(const Set<T> &set)
+    {
+        std::vector<T> sorted = sorted_keys(set);
+
+        owned = allocate(sorted.size() + 1);
+        std::memset(static_cast<void *>(owned), 0, sizeof(T));
+        eytzinger(sorted, owned, 0, 1);
+
+        keys = owned;
+        count = sorted.size();
+    }
+
+    FrozenSet(const FrozenSet &) = delete;
+    FrozenSet &operator=(const FrozenSet &) = delete;
+
+    FrozenSet(FrozenSet &&other) noexcept
+        : keys(std::exchange(other.keys, nullptr)), count(std::exchange(other.count, 0)),
+          mapping(std::exchange(other.mapping, nullptr)), mapping_size(std::exchange(other.mapping_size, 0)),
+          owned(std::exchange(other.owned, nullptr)) {}
+
+    FrozenSet &operator=(FrozenSet &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            keys = std::exchange(other.keys, nullptr);
+            count = std::exchange(other.count, 0);
+            mapping = std::exchange(other.mapping, nullptr);
+            mapping_size = std::exchange(other.mapping_size, 0);
+            owned = std::exchange(other.owned, nullptr);
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Libera a memória ou desfaz o mapeamento do arquivo.
+     */
+    ~FrozenSet()
+    {
+        release();
+    }
+
+    /**
+     * @brief Grava as chaves de `set` no formato de `FrozenSet`.
+     *
+     * @param set O conjunto de origem.
+     * @param out O fluxo de saída, em modo binário.
+     * @throw std::runtime_error Se a escrita falhar.
+     */
+    static void write(const Set<T> &set, std::ostream &out)
+    {
+        std::vector<T> sorted = sorted_keys(set);
+
+        FrozenSetHeader header{};
+        std::memcpy(header.magic, FrozenSetHeader::MAGIC, sizeof(header.magic));
+        header.type_tag = KeyCodec<T>::TYPE_TAG;
+        header.key_size = sizeof(T);
+        header.count = sorted.size();
+        header.keys_offset = FrozenSetHeader::KEYS_OFFSET;
+
+        char padding[FrozenSetHeader::KEYS_OFFSET] = {};
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(padding, FrozenSetHeader::KEYS_OFFSET - sizeof(header));
+
+        std::vector<T> layout(sorted.size() + 1);
+        std::memset(static_cast<void *>(layout.data()), 0, sizeof(T));
+        eytzinger(sorted, layout.data(), 0, 1);
+        out.write(reinterpret_cast<const char *>(layout.data()), layout.size() * sizeof(T));
+
+        if (!out)
+            throw std::runtime_error("Falha ao gravar o FrozenSet");
+    }
+
+    /**
+     * @brief Grava as chaves de `set` no arquivo `path`, no formato de `FrozenSet`.
+     *
+     * @throw std::runtime_error Se o arquivo não puder ser aberto ou escrito.
+     */
+    static void write(const Set<T> &set, const std::string &path)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("Nao foi possivel abrir o arquivo: " + path);
+
+        write(set, out);
+    }
+
+    /**
+     * @brief Abre um arquivo gravado por `write`, mapeando-o somente para leitura.
+     *
+     * @param path O caminho do arquivo.
+     * @return FrozenSet O conjunto, válido enquanto o objeto existir.
+     * @throw std::runtime_error Se o arquivo não puder ser aberto ou o cabeçalho for inválido.
+     */
+    static FrozenSet open(const std::string &path)
+    {
+        FrozenSet result;
+
+#if FROZEN_SET_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Nao foi possivel abrir o arquivo: " + path);
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 or static_cast<size_t>(info.st_size) < sizeof(FrozenSetHeader))
+        {
+            ::close(fd);
+            throw std::runtime_error("Arquivo de FrozenSet truncado");
+        }
+
+        size_t size = static_cast<size_t>(info.st_size);
+        void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        if (mapping == MAP_FAILED)
+            throw std::runtime_error("Nao foi possivel mapear o arquivo: " + path);
+
+        result.mapping = mapping;
+        result.mapping_size = size;
+
+        FrozenSetHeader header;
+        std::memcpy(&header, mapping, sizeof(header));
+        validate(header, size); // Em caso de erro, o destrutor de `result` desfaz o mapeamento
+
+        result.keys = reinterpret_cast<const T *>(static_cast<const char *>(mapping) + header.keys_offset);
+        result.count = header.count;
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in)
+            throw std::runtime_error("Nao foi possivel abrir o arquivo: " + path);
+
+        size_t size = static_cast<size_t>(in.tellg());
+        in.seekg(0);
+
+        FrozenSetHeader header;
+        if (size < sizeof(header) or !in.read(reinterpret_cast<char *>(&header), sizeof(header)))
+            throw std::runtime_error("Arquivo de FrozenSet truncado");
+        validate(header, size);
+
+        result.owned = allocate(header.count + 1);
+        in.seekg(header.keys_offset);
+        in.read(reinterpret_cast<char *>(result.owned), (header.count + 1) * sizeof(T));
+        if (!in)
+            throw std::runtime_error("Arquivo de FrozenSet truncado");
+
+        result.keys = result.owned;
+        result.count = header.count;
+#endif
+
+        return result;
+    }
+
+    size_t size() const noexcept
+    {
+        return count;
+    }
+
+    bool empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    /**
+     * @brief Verifica se o conjunto contém uma chave.
+     */
+    bool contains(const T &key) const noexcept
+    {
+        size_t k = lower_bound_index(key);
+        return k != 0 and !(key < keys[k]);
+    }
+
+    /**
+     * @brief Retorna um iterador para a menor chave `>= key`, ou `end()` se não houver.
+     */
+    const_iterator lower_bound(const T &key) const noexcept
+    {
+        return const_iterator(keys, count, lower_bound_index(key));
+    }
+
+    const_iterator begin() const noexcept
+    {
+        if (count == 0)
+            return end();
+
+        size_t k = 1;
+        while (2 * k <= count)
+            k = 2 * k;
+
+        return const_iterator(keys, count, k);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(keys, count, 0);
+    }
+
+    /**
+     * @brief Retorna o menor elemento, ou `std::nullopt` se vazio.
+     */
+    std::optional<T> try_min() const
+    {
+        if (count == 0)
+            return std::nullopt;
+
+        return *begin();
+    }
+
+    /**
+     * @brief Retorna o maior elemento, ou `std::nullopt` se vazio.
+     */
+    std::optional<T> try_max() const
+    {
+        if (count == 0)
+            return std::nullopt;
+
+        size_t k = 1;
+        while (2 * k + 1 <= count)
+            k = 2 * k + 1;
+
+        return keys[k];
+    }
+
+    /**
+     * @brief Chama `f(chave)` para cada elemento, em ordem crescente.
+     */
+    template <typename F>
+    void for_each(F f) const
+    {
+        for (const T &key : *this)
+            f(key);
+    }
+};
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Sequência preguiçosa produzida por uma corrotina C++20 com `co_yield`.
+ *
+ * A corrotina só executa quando o próximo valor é pedido, e cada valor produzido é
+ * acessado por referência enquanto a corrotina está suspensa, sem cópias nem vetores
+ * intermediários. Pode ser percorrida uma única vez com `begin()`/`end()` (um
+ * `for` por intervalo) ou avançada manualmente com `next()`, o que permite intercalar
+ * vários geradores.
+ *
+ * Exceções lançadas pela corrotina são propagadas para quem pediu o valor.
+ *
+ * @tparam T Tipo dos valores produzidos.
+ */
+template <class T>
+class Generator
+{
+public:
+    struct promise_type
+    {
+        const T *current{nullptr};
+        std::exception_ptr exception;
+
+        Generator get_return_object() noexcept
+        {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always yield_value(const T &value) noexcept
+        {
+            current = std::addressof(value);
+            return {};
+        }
+
+        void return_void() const noexcept {}
+
+        void unhandled_exception() noexcept
+        {
+            exception = std::current_exception();
+        }
+
+        /**
+         * @brief Um gerador não pode usar `co_await`.
+         */
+        template <typename U>
+        std::suspend_never await_transform(U &&) = delete;
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    class iterator
+    {
+    private:
+        Handle handle{nullptr};
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = const T &;
+        using pointer = const T *;
+
+        iterator() = default;
+        explicit iterator(Handle handle) : handle(handle) {}
+
+        reference operator*() const
+        {
+            return *handle.promise().current;
+        }
+
+        pointer operator->() const
+        {
+            return handle.promise().current;
+        }
+
+        iterator &operator++()
+        {
+            Generator::resume(handle);
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        bool operator==(std::default_sentinel_t) const noexcept
+        {
+            return handle == nullptr or handle.done();
+        }
+    };
+
+private:
+    Handle handle{nullptr};
+
+    explicit Generator(Handle handle) noexcept : handle(handle) {}
+
+    static void resume(Handle handle)
+    {
+        handle.resume();
+
+        if (handle.promise().exception)
+            std::rethrow_exception(std::exchange(handle.promise().exception, nullptr));
+    }
+
+public:
+    Generator(Generator &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+    Generator &operator=(Generator &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle)
+                handle.destroy();
+
+            handle = std::exchange(other.handle, nullptr);
+        }
+
+        return *this;
+    }
+
+    Generator(const Generator &) = delete;
+    Generator &operator=(const Generator &) = delete;
+
+    ~Generator()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    /**
+     * @brief Inicia a corrotina até o primeiro valor. Deve ser chamado uma única vez.
+     */
+    iterator begin()
+    {
+        if (handle)
+            resume(handle);
+
+        return iterator(handle);
+    }
+
+    std::default_sentinel_t end() const noexcept
+    {
+        return std::default_sentinel;
+    }
+
+    /**
+     * @brief Avança até o próximo valor e retorna um ponteiro para ele, ou `nullptr` no fim.
+     *
+     * O ponteiro vale até a próxima chamada. Não deve ser misturado com `begin()`.
+     */
+    const T *next()
+    {
+        if (handle == nullptr or handle.done())
+            return nullptr;
+
+        resume(handle);
+        return handle.done() ? nullptr : handle.promise().current;
+    }
+};
@@ -0,0 +1,308 @@
+#pragma once
+
+#include "workload/Workload.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Histograma de latências em escala log-linear, no estilo do HdrHistogram.
+ *
+ * Valores abaixo de 32 têm um balde cada; acima disso, cada potência de dois é dividida
+ * em 32 baldes de mesma largura, então qualquer valor registrado é recuperado com erro
+ * relativo de no máximo 1/32 (cerca de 3%). São 1920 baldes fixos (15 KiB), suficientes
+ * para todo o intervalo de `uint64_t`, e `record` custa alguns ciclos, sem alocação.
+ *
+ * Os baldes são atômicos com leitura e escrita relaxadas: uma única thread pode
+ * registrar enquanto outras leem (`merge`, `percentile`) sem condição de corrida.
+ * Registros concorrentes de várias threads no mesmo histograma podem se perder; para
+ * isso há o `LatencyRecorder`, com um histograma por thread.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max_value{0};
+
+    static void add(std::atomic<uint64_t> &counter, uint64_t n) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    static void raise(std::atomic<uint64_t> &counter, uint64_t candidate) noexcept
+    {
+        if (candidate > counter.load(std::memory_order_relaxed))
+            counter.store(candidate, std::memory_order_relaxed);
+    }
+
+public:
+    LatencyHistogram() = default;
+
+    LatencyHistogram(const LatencyHistogram &other) noexcept
+    {
+        merge(other);
+    }
+
+    LatencyHistogram &operator=(const LatencyHistogram &other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            merge(other);
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Índice do balde que contém `value`.
+     */
+    static size_t bucket_of(uint64_t value) noexcept
+    {
+        if (value < SUB_BUCKETS)
+            return static_cast<size_t>(value);
+
+        unsigned exponent = static_cast<unsigned>(std::bit_width(value)) - 1;
+        unsigned shift = exponent - SUB_BUCKET_BITS;
+
+        return static_cast<size_t>((shift + 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS));
+    }
+
+    /**
+     * @brief Maior valor que cai no balde `index`.
+     */
+    static uint64_t bucket_upper(size_t index) noexcept
+    {
+        if (index < SUB_BUCKETS)
+            return index;
+
+        unsigned shift = static_cast<unsigned>(index / SUB_BUCKETS) - 1;
+        uint64_t lower = (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+
+        return lower + ((uint64_t(1) << shift) - 1);
+    }
+
+    void record(uint64_t value) noexcept
+    {
+        add(buckets[bucket_of(value)], 1);
+        add(total, 1);
+        add(sum, value);
+        raise(max_value, value);
+    }
+
+    /**
+     * @brief Soma os registros de `other` a este histograma.
+     */
+    void merge(const LatencyHistogram &other) noexcept
+    {
+        for (size_t i = 0; i < BUCKETS; i++)
+            if (uint64_t n = other.buckets[i].load(std::memory_order_relaxed))
+                add(buckets[i], n);
+
+        add(total, other.total.load(std::memory_order_relaxed));
+        add(sum, other.sum.load(std::memory_order_relaxed));
+        raise(max_value, other.max_value.load(std::memory_order_relaxed));
+    }
+
+    void reset() noexcept
+    {
+        for (std::atomic<uint64_t> &bucket : buckets)
+            bucket.store(0, std::memory_order_relaxed);
+
+        total.store(0, std::memory_order_relaxed);
+        sum.store(0, std::memory_order_relaxed);
+        max_value.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const noexcept
+    {
+        return total.load(std::memory_order_relaxed);
+    }
+
+    uint64_t max() const noexcept
+    {
+        return max_value.load(std::memory_order_relaxed);
+    }
+
+    double mean() const noexcept
+    {
+        uint64_t n = count();
+        return n == 0 ? 0.0 : static_cast<double>(sum.load(std::memory_order_relaxed)) / static_cast<double>(n);
+    }
+
+    /**
+     * @brief Menor valor `v` (arredondado para o fim do seu balde) tal que pelo menos uma
+     * fração `p` dos registros é menor ou igual a `v`. Retorna 0 se o histograma estiver vazio.
+     *
+     * @param p Fração entre 0 e 1 (0.99 para o p99).
+     */
+    uint64_t percentile(double p) const noexcept
+    {
+        uint64_t n = count();
+        if (n == 0)
+            return 0;
+
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 1.0) * static_cast<double>(n))));
+        uint64_t seen = 0;
+
+        for (size_t i = 0; i < BUCKETS; i++)
+        {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank)
+                return std::min(bucket_upper(i), max());
+        }
+
+        return max();
+    }
+};
+
+/**
+ * @brief Histogramas de latência por tipo de operação (`workload::OpType`), com um
+ * conjunto de histogramas por thread.
+ *
+ * Cada thread registra apenas nos seus próprios histogramas, sem locks nem operações
+ * atômicas de leitura-modificação-escrita; o lock é usado só no primeiro registro de
+ * cada thread. As leituras (`histogram`, `write_text`, `write_json`) somam os
+ * histogramas de todas as threads, inclusive das que já terminaram.
+ */
+class LatencyRecorder
+{
+private:
+    using Histograms = std::array<LatencyHistogram, workload::OP_TYPES>;
+
+    const uint64_t id;
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Histograms>> shards;
+
+    static uint64_t next_id() noexcept
+    {
+        static std::atomic<uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Histogramas da thread atual, criados no primeiro uso.
+     *
+     * O cache por thread é indexado pelo identificador do registrador, que nunca é
+     * reutilizado, então entradas de registradores já destruídos nunca são consultadas.
+     */
+    Histograms &local()
+    {
+        thread_local std::vector<std::pair<uint64_t, Histograms *>> cache;
+
+        for (const auto &[owner, histograms] : cache)
+            if (owner == id)
+                return *histograms;
+
+        std::lock_guard lock(mutex);
+        shards.push_back(std::make_unique<Histograms>());
+        cache.emplace_back(id, shards.back().get());
+
+        return *shards.back();
+    }
+
+public:
+    LatencyRecorder() : id(next_id()) {}
+
+    LatencyRecorder(const LatencyRecorder &) = delete;
+    LatencyRecorder &operator=(const LatencyRecorder &) = delete;
+
+    void record(workload::OpType type, uint64_t nanoseconds)
+    {
+        local()[static_cast<size_t>(type)].record(nanoseconds);
+    }
+
+    /**
+     * @brief Histograma de `type` somado de todas as threads.
+     */
+    LatencyHistogram histogram(workload::OpType type) const
+    {
+        LatencyHistogram merged;
+        std::lock_guard lock(mutex);
+
+        for (const auto &shard : shards)
+            merged.merge((*shard)[static_cast<size_t>(type)]);
+
+        return merged;
+    }
+
+    /**
+     * @brief Zera todos os histogramas. Registros feitos durante a chamada podem se perder.
+     */
+    void reset()
+    {
+        std::lock_guard lock(mutex);
+
+        for (const auto &shard : shards)
+            for (LatencyHistogram &histogram : *shard)
+                histogram.reset();
+    }
+
+    /**
+     * @brief Tabela com quantidade, p50, p99, p99.9 e máximo (em ns) de cada operação registrada.
+     */
+    void write_text(std::ostream &out) const
+    {
+        // Formata em um fluxo próprio para não alterar os flags de `out`
+        std::ostringstream table;
+        table << std::left << std::setw(14) << "operacao" << std::right << std::setw(12) << "quantidade"
+              << std::setw(11) << "p50 ns" << std::setw(11) << "p99 ns" << std::setw(11) << "p99.9 ns"
+              << std::setw(11) << "max ns" << "\n";
+
+        for (size_t type = 1; type < workload::OP_TYPES; type++)
+        {
+            LatencyHistogram h = histogram(static_cast<workload::OpType>(type));
+            if (h.count() == 0)
+                continue;
+
+            table << std::left << std::setw(14) << workload::to_string(static_cast<workload::OpType>(type)) << std::right
+                  << std::setw(12) << h.count() << std::setw(11) << h.percentile(0.5) << std::setw(11) << h.percentile(0.99)
+                  << std::setw(11) << h.percentile(0.999) << std::setw(11) << h.max() << "\n";
+        }
+
+        out << table.str();
+    }
+
+    /**
+     * @brief Objeto JSON com uma entrada por operação registrada, por exemplo
+     * `{"insert": {"count": 10, "mean": 512.3, "p50": 480, "p99": 900, "p999": 1200, "max": 1500}}`.
+     */
+    void write_json(std::ostream &out) const
+    {
+        out << "{";
+        bool first = true;
+
+        for (size_t type = 1; type < workload::OP_TYPES; type++)
+        {
+            LatencyHistogram h = histogram(static_cast<workload::OpType>(type));
+            if (h.count() == 0)
+                continue;
+
+            out << (first ? "" : ", ") << "\"" << workload::to_string(static_cast<workload::OpType>(type)) << "\": {"
+                << "\"count\": " << h.count() << ", \"mean\": " << h.mean() << ", \"p50\": " << h.percentile(0.5)
+                << ", \"p99\": " << h.percentile(0.99) << ", \"p999\": " << h.percentile(0.999)
+                << ", \"max\": " << h.max() << "}";
+            first = false;
+        }
+
+        out << "}";
+    }
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "latency/LatencyHistogram.hpp"
+#include "set/Set.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+/**
+ * @brief Invólucro que mede a latência de cada operação de um conjunto e a registra em
+ * um `LatencyRecorder`, por tipo de operação.
+ *
+ * O relógio (`std::chrono::steady_clock`) é lido antes e depois de cada operação, o que
+ * acrescenta algumas dezenas de nanossegundos a cada medida. Operações que lançam
+ * exceção também são registradas.
+ *
+ * Vários `TimedSet` em threads diferentes podem compartilhar o mesmo registrador; o
+ * conjunto embrulhado precisa ser thread-safe nesse caso (por exemplo, `ConcurrentSet<T>`).
+ *
+ * @tparam T Tipo dos elementos.
+ * @tparam SetType Tipo do conjunto embrulhado. Só os métodos usados precisam existir nele.
+ */
+template <class T, class SetType = Set<T>>
+class TimedSet
+{
+private:
+    using Clock = std::chrono::steady_clock;
+
+    SetType &set;
+    LatencyRecorder &recorder;
+
+    /**
+     * @brief Registra o tempo decorrido desde a construção ao sair do escopo, mesmo com exceção.
+     */
+    class Scope
+    {
+    private:
+        LatencyRecorder &recorder;
+        workload::OpType type;
+        Clock::time_point start;
+
+    public:
+        Scope(LatencyRecorder &recorder, workload::OpType type) : recorder(recorder), type(type), start(Clock::now()) {}
+
+        ~Scope()
+        {
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+            recorder.record(type, static_cast<uint64_t>(elapsed.count()));
+        }
+    };
+
+public:
+    TimedSet(SetType &set, LatencyRecorder &recorder) : set(set), recorder(recorder) {}
+
+    void insert(const T &key)
+    {
+        Scope scope(recorder, workload::OpType::Insert);
+        set.insert(key);
+    }
+
+    void erase(const T &key)
+    {
+        Scope scope(recorder, workload::OpType::Erase);
+        set.erase(key);
+    }
+
+    bool contains(const T &key) const
+    {
+        Scope scope(recorder, workload::OpType::Contains);
+        return set.contains(key);
+    }
+
+    T successor(const T &key) const
+    {
+        Scope scope(recorder, workload::OpType::Successor);
+        return set.successor(key);
+    }
+
+    T predecessor(const T &key) const
+    {
+        Scope scope(recorder, workload::OpType::Predecessor);
+        return set.predecessor(key);
+    }
+
+    std::optional<T> find_next(const T &key) const
+    {
+        Scope scope(recorder, workload::OpType::Successor);
+        return set.find_next(key);
+    }
+
+    std::optional<T> find_prev(const T &key) const
+    {
+        Scope scope(recorder, workload::OpType::Predecessor);
+        return set.find_prev(key);
+    }
+
+    void clear()
+    {
+        Scope scope(recorder, workload::OpType::Clear);
+        set.clear();
+    }
+
+    size_t size() const
+    {
+        return set.size();
+    }
+
+    /**
+     * @brief Acesso ao conjunto embrulhado, para operações que não são medidas.
+     */
+    SetType &view() const noexcept
+    {
+        return set;
+    }
+};
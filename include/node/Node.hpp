@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+
 /**
  * @brief Estrutura que representa um nó em uma árvore binária, comumente utilizada em árvores AVL.
  *
@@ -33,6 +36,12 @@
  *   Aponta para o nó filho à direita. Se o nó não possuir um filho direito,
  *   este ponteiro será `nullptr`.
  *
+ * - `refs` (do tipo `std::atomic<size_t>`):
+ *   Número de referências (pais ou raízes de conjuntos) que apontam para este nó.
+ *   Cópias de `Set` compartilham subárvores; um nó só pode ser modificado no lugar
+ *   quando `refs == 1` e todos os seus ancestrais também são exclusivos. O contador
+ *   é atômico para que cópias possam ser destruídas em threads diferentes.
+ *
  * ### Construtor:
  *
  * `Node(const T &key, const int &height = 1, Node<T> *left = nullptr, Node<T> *right = nullptr)`
@@ -49,7 +58,8 @@
  *                 O valor padrão é `nullptr`.
  *
  *   O construtor utiliza uma lista de inicialização de membros para definir os
- *   valores `key`, `height`, `left` e `right` com os parâmetros fornecidos.
+ *   valores `key`, `height`, `left` e `right` com os parâmetros fornecidos. O novo
+ *   nó começa com `refs == 1`.
  */
 template <typename T>
 struct Node
@@ -58,7 +68,8 @@ struct Node
     int height;
     Node<T> *left;
     Node<T> *right;
+    std::atomic<size_t> refs;
 
     Node(const T &key, const int &height = 1, Node<T> *left = nullptr, Node<T> *right = nullptr)
-        : key(key), height(height), left(left), right(right) {}
+        : key(key), height(height), left(left), right(right), refs(1) {}
 };
\ No newline at end of file
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "set/Set.hpp"
+
+#include <initializer_list>
+#include <optional>
+#include <utility>
+
+/**
+ * @brief Conjunto AVL persistente com cópia de caminho e snapshots em O(1).
+ *
+ * É uma interface sobre o copy-on-write de `Set`: os nós têm contador de referências
+ * atômico e são compartilhados por todas as versões. `snapshot()` apenas compartilha a
+ * raiz; uma modificação posterior copia somente os nós do caminho (e os irmãos tocados
+ * por rotações) que ainda estão compartilhados, de modo que cada versão antiga continua
+ * válida e imutável. Inserir uma chave existente ou remover uma ausente não copia nada.
+ *
+ * Qualquer cópia de `Set` já tem esse comportamento; esta classe deixa explícita, com
+ * `snapshot()`, a intenção de guardar versões.
+ *
+ * Versões distintas podem ser lidas e destruídas em threads diferentes; uma mesma
+ * versão não deve ser modificada concorrentemente.
+ *
+ * @tparam T Tipo dos elementos armazenados no conjunto. Deve suportar `<` e `==`.
+ */
+template <class T>
+class PersistentSet
+{
+private:
+    Set<T> set;
+
+public:
+    /**
+     * @brief Construtor padrão. Cria um conjunto vazio.
+     */
+    PersistentSet() = default;
+
+    /**
+     * @brief Construtor a partir de uma lista inicializadora.
+     *
+     * @param list A lista de inicialização (`std::initializer_list<T>`).
+     */
+    PersistentSet(std::initializer_list<T> list) : set(list) {}
+
+    /**
+     * @brief Construtor de cópia em O(1): as duas versões passam a compartilhar a árvore.
+     */
+    PersistentSet(const PersistentSet &other) = default;
+
+    PersistentSet(PersistentSet &&other) noexcept
+    {
+        set.swap(other.set);
+    }
+
+    PersistentSet &operator=(PersistentSet other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    /**
+     * @brief Retorna uma versão imutável do estado atual em O(1).
+     *
+     * Modificações posteriores em `*this` não afetam o snapshot, e vice-versa.
+     */
+    PersistentSet snapshot() const
+    {
+        return PersistentSet(*this);
+    }
+
+    void swap(PersistentSet &other) noexcept
+    {
+        set.swap(other.set);
+    }
+
+    size_t size() const noexcept
+    {
+        return set.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return set.empty();
+    }
+
+    /**
+     * @brief Esvazia esta versão; as demais versões não são afetadas.
+     */
+    void clear()
+    {
+        set.clear();
+    }
+
+    /**
+     * @brief Insere uma chave, copiando apenas os nós compartilhados do caminho.
+     *
+     * Se a chave já existir, nada é copiado.
+     */
+    void insert(const T &key)
+    {
+        set.insert(key);
+    }
+
+    /**
+     * @brief Remove uma chave, copiando apenas os nós compartilhados do caminho.
+     *
+     * Se a chave não existir, nada é copiado.
+     */
+    void erase(const T &key)
+    {
+        set.erase(key);
+    }
+
+    bool contains(const T &key) const
+    {
+        return set.contains(key);
+    }
+
+    std::optional<T> try_min() const
+    {
+        return set.try_min();
+    }
+
+    std::optional<T> try_max() const
+    {
+        return set.try_max();
+    }
+
+    /**
+     * @brief Chama `f(chave)` para cada elemento, em ordem crescente.
+     */
+    template <typename F>
+    void for_each(F f) const
+    {
+        set.for_each(f);
+    }
+
+    /**
+     * @brief Acesso somente leitura a esta versão como `Set`, para as demais consultas.
+     */
+    const Set<T> &view() const noexcept
+    {
+        return set;
+    }
+};
@@ -0,0 +1,545 @@
+#pragma once
+
+#include "set/Set.hpp"
+#include "serialization/Serialization.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Conjunto de inteiros imutável e comprimido, com blocos de deltas empacotados em bits.
+ *
+ * As chaves ordenadas são divididas em blocos de `BLOCK_SIZE` chaves. Cada bloco guarda
+ * a primeira chave (`base`) e as diferenças entre chaves consecutivas menos 1, empacotadas
+ * com a menor largura de bits que comporta a maior diferença do bloco (frame of
+ * reference). Um conjunto denso como {1, ..., 10} tem diferenças nulas e largura 0.
+ *
+ * Os cabeçalhos dos blocos (base, largura e posição) ficam separados dos dados e servem
+ * de índice: `contains` e `for_each_in_range` localizam o bloco por busca binária nas
+ * bases e decodificam apenas os blocos necessários.
+ *
+ * Formato gravado por `save` (inteiros em LEB128; bases com zigzag para tipos com sinal):
+ * `"AVLP"`, tipo das chaves (`KeyCodec<T>::TYPE_TAG`), quantidade, tamanho do bloco,
+ * e para cada bloco: base, largura (1 byte) e os bits empacotados; por fim, os 32 bits
+ * baixos do FNV-1a de tudo o que veio antes.
+ *
+ * @tparam T Tipo inteiro das chaves (com ou sem sinal, exceto `bool`).
+ */
+template <class T>
+class PackedSet
+{
+    static_assert(std::is_integral_v<T> and !std::is_same_v<T, bool>, "PackedSet requer chaves inteiras");
+
+private:
+    using U = std::make_unsigned_t<T>;
+
+    static constexpr size_t BLOCK_SIZE = 128;
+    static constexpr char MAGIC[4] = {'A', 'V', 'L', 'P'};
+
+    /**
+     * @brief Bytes extras no fim de `payload`, para que `read_bits` sempre leia 9 bytes.
+     */
+    static constexpr size_t PADDING = 9;
+
+    size_t count{0};
+    std::vector<U> bases;           // Primeira chave de cada bloco, em `to_ordered`
+    std::vector<uint8_t> widths;    // Largura em bits das diferenças de cada bloco
+    std::vector<size_t> offsets;    // Posição (em bits) das diferenças de cada bloco em `payload`
+    std::vector<uint8_t> payload{}; // Diferenças empacotadas, seguidas de `PADDING` bytes nulos
+
+    /**
+     * @brief Mapeia a chave para um inteiro sem sinal com a mesma ordem.
+     */
+    static U to_ordered(T key) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return static_cast<U>(key) ^ (U(1) << (std::numeric_limits<U>::digits - 1));
+        else
+            return key;
+    }
+
+    static T from_ordered(U value) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return static_cast<T>(value ^ (U(1) << (std::numeric_limits<U>::digits - 1)));
+        else
+            return value;
+    }
+
+    static uint64_t read_bits(const uint8_t *data, size_t position, unsigned width) noexcept
+    {
+        if (width == 0)
+            return 0;
+
+        const uint8_t *bytes = data + position / 8;
+        unsigned shift = position % 8;
+
+        uint64_t word = 0;
+        for (int i = 7; i >= 0; i--)
+            word = (word << 8) | bytes[i];
+
+        uint64_t value = word >> shift;
+        if (shift + width > 64)
+            value |= static_cast<uint64_t>(bytes[8]) << (64 - shift);
+
+        return (width == 64) ? value : value & ((uint64_t(1) << width) - 1);
+    }
+
+    static void write_bits(std::vector<uint8_t> &data, size_t position, uint64_t value, unsigned width)
+    {
+        for (unsigned written = 0; written < width;)
+        {
+            size_t byte = (position + written) / 8;
+            unsigned shift = (position + written) % 8;
+            unsigned chunk = std::min(width - written, 8 - shift);
+
+            data[byte] |= static_cast<uint8_t>(((value >> written) & ((1u << chunk) - 1)) << shift);
+            written += chunk;
+        }
+    }
+
+    size_t block_length(size_t block) const noexcept
+    {
+        return std::min(BLOCK_SIZE, count - block * BLOCK_SIZE);
+    }
+
+    /**
+     * @brief Decodifica o bloco `block` a partir de seu início, chamando `f(chave ordenada)`
+     * até que `f` retorne `false`. Retorna `false` se a decodificação foi interrompida.
+     */
+    template <typename F>
+    bool decode_block(size_t block, F &&f) const
+    {
+        U value = bases[block];
+        if (!f(value))
+            return false;
+
+        unsigned width = widths[block];
+        size_t position = offsets[block];
+
+        for (size_t i = 1; i < block_length(block); i++)
+        {
+            value += static_cast<U>(read_bits(payload.data(), position, width)) + 1;
+            position += width;
+
+            if (!f(value))
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Índice do último bloco cuja base é `<= value`, ou `bases.size()` se não houver.
+     */
+    size_t find_block(U value) const noexcept
+    {
+        auto it = std::upper_bound(bases.begin(), bases.end(), value);
+        return (it == bases.begin()) ? bases.size() : static_cast<size_t>(it - bases.begin() - 1);
+    }
+
+    void build(const std::vector<U> &keys)
+    {
+        count = keys.size();
+        size_t blocks = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+        bases.resize(blocks);
+        widths.resize(blocks);
+        offsets.resize(blocks);
+
+        size_t bits = 0;
+        for (size_t b = 0; b < blocks; b++)
+        {
+            size_t first = b * BLOCK_SIZE;
+            size_t last = std::min(first + BLOCK_SIZE, count);
+
+            U max_delta = 0;
+            for (size_t i = first + 1; i < last; i++)
+                max_delta = std::max<U>(max_delta, keys[i] - keys[i - 1] - 1);
+
+            bases[b] = keys[first];
+            widths[b] = static_cast<uint8_t>(std::bit_width(max_delta));
+            offsets[b] = bits;
+            bits += (last - first - 1) * widths[b];
+        }
+
+        payload.assign((bits + 7) / 8 + PADDING, 0);
+
+        for (size_t b = 0; b < blocks; b++)
+        {
+            size_t position = offsets[b];
+            for (size_t i = b * BLOCK_SIZE + 1; i < std::min((b + 1) * BLOCK_SIZE, count); i++)
+            {
+                write_bits(payload, position, keys[i] - keys[i - 1] - 1, widths[b]);
+                position += widths[b];
+            }
+        }
+    }
+
+    static void put_varint(std::vector<uint8_t> &out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    /**
+     * @brief Base gravada no arquivo: zigzag da chave para tipos com sinal, para que
+     * chaves pequenas ocupem poucos bytes.
+     */
+    static uint64_t base_to_file(U base) noexcept
+    {
+        T key = from_ordered(base);
+
+        if constexpr (std::is_signed_v<T>)
+            return (static_cast<uint64_t>(static_cast<int64_t>(key)) << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(key) >> 63);
+        else
+            return key;
+    }
+
+    static U base_from_file(uint64_t value) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return to_ordered(static_cast<T>(static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1)));
+        else
+            return static_cast<U>(value);
+    }
+
+    static uint32_t checksum(const std::vector<uint8_t> &bytes, size_t size)
+    {
+        Fnv1a hash;
+        hash.update(reinterpret_cast<const char *>(bytes.data()), size);
+        return static_cast<uint32_t>(hash.value());
+    }
+
+    /**
+     * @brief Leitura sob demanda de um fluxo, sem consumir nada além dos bytes pedidos,
+     * que acumula o checksum do que foi lido.
+     */
+    class Input
+    {
+    private:
+        std::istream &in;
+        Fnv1a hash;
+
+    public:
+        explicit Input(std::istream &in) : in(in) {}
+
+        /**
+         * @brief Lê exatamente `size` bytes para `data`, sem incluí-los no checksum.
+         */
+        void raw(void *data, size_t size)
+        {
+            if (in.rdbuf()->sgetn(static_cast<char *>(data), static_cast<std::streamsize>(size)) != static_cast<std::streamsize>(size))
+            {
+                in.setstate(std::ios::eofbit | std::ios::failbit);
+                throw std::runtime_error("Arquivo de PackedSet truncado");
+            }
+        }
+
+        /**
+         * @brief Inclui no checksum bytes já lidos por fora.
+         */
+        void update(const void *data, size_t size)
+        {
+            hash.update(static_cast<const char *>(data), size);
+        }
+
+        void read(void *data, size_t size)
+        {
+            raw(data, size);
+            update(data, size);
+        }
+
+        uint8_t byte()
+        {
+            uint8_t value;
+            read(&value, 1);
+            return value;
+        }
+
+        uint64_t varint()
+        {
+            uint64_t value = 0;
+
+            for (unsigned shift = 0; shift < 64; shift += 7)
+            {
+                uint8_t current = byte();
+                value |= static_cast<uint64_t>(current & 0x7f) << shift;
+
+                if ((current & 0x80) == 0)
+                    return value;
+            }
+
+            throw std::runtime_error("Arquivo de PackedSet corrompido");
+        }
+
+        uint32_t checksum() const noexcept
+        {
+            return static_cast<uint32_t>(hash.value());
+        }
+    };
+
+public:
+    /**
+     * @brief Cria um conjunto comprimido vazio.
+     */
+    PackedSet()
+    {
+        payload.assign(PADDING, 0);
+    }
+
+    /**
+     * @brief Comprime as chaves de `set`.
+     */
+    explicit PackedSet(const Set<T> &set)
+    {
+        std::vector<U> keys;
+        keys.reserve(set.size());
+        set.for_each([&keys](T key)
+                     { keys.push_back(to_ordered(key)); });
+
+        build(keys);
+    }
+
+    size_t size() const noexcept
+    {
+        return count;
+    }
+
+    bool empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    /**
+     * @brief Verifica se o conjunto contém `key`, decodificando no máximo um bloco.
+     */
+    bool contains(T key) const
+    {
+        U value = to_ordered(key);
+        size_t block = find_block(value);
+        if (block == bases.size())
+            return false;
+
+        bool found = false;
+        decode_block(block, [value, &found](U current)
+                     {
+                         found = current == value;
+                         return current < value; });
+
+        return found;
+    }
+
+    /**
+     * @brief Chama `f(chave)` para cada chave em `[low, high]`, em ordem crescente,
+     * decodificando apenas os blocos que intersectam o intervalo.
+     */
+    template <typename F>
+    void for_each_in_range(T low, T high, F f) const
+    {
+        if (high < low or count == 0)
+            return;
+
+        U lo = to_ordered(low);
+        U hi = to_ordered(high);
+
+        size_t block = find_block(lo);
+        if (block == bases.size())
+            block = 0;
+
+        for (; block < bases.size() and bases[block] <= hi; block++)
+        {
+            bool more = decode_block(block, [lo, hi, &f](U current)
+                                     {
+                                         if (current > hi)
+                                             return false;
+                                         if (current >= lo)
+                                             f(from_ordered(current));
+                                         return true; });
+            if (!more)
+                return;
+        }
+    }
+
+    /**
+     * @brief Chama `f(chave)` para cada chave, em ordem crescente.
+     */
+    template <typename F>
+    void for_each(F f) const
+    {
+        for (size_t block = 0; block < bases.size(); block++)
+            decode_block(block, [&f](U current)
+                         {
+                             f(from_ordered(current));
+                             return true; });
+    }
+
+    /**
+     * @brief Descomprime para um `Set`.
+     */
+    Set<T> to_set() const
+    {
+        std::vector<T> keys;
+        keys.reserve(count);
+        for_each([&keys](T key)
+                 { keys.push_back(key); });
+
+        // A ordem e a ausência de repetições são garantidas pelo formato
+        return Set<T>::from_sorted(keys, std::thread::hardware_concurrency());
+    }
+
+    /**
+     * @brief Grava o conjunto no formato comprimido.
+     *
+     * @throw std::runtime_error Se a escrita falhar.
+     */
+    void save(std::ostream &out) const
+    {
+        std::vector<uint8_t> bytes(MAGIC, MAGIC + sizeof(MAGIC));
+        put_varint(bytes, KeyCodec<T>::TYPE_TAG);
+        put_varint(bytes, count);
+        put_varint(bytes, BLOCK_SIZE);
+
+        std::vector<uint8_t> block_bits;
+        for (size_t block = 0; block < bases.size(); block++)
+        {
+            put_varint(bytes, base_to_file(bases[block]));
+            bytes.push_back(widths[block]);
+
+            // Reempacota a partir do bit 0 para que o bloco comece em um byte inteiro
+            size_t bits = (block_length(block) - 1) * widths[block];
+            block_bits.assign((bits + 7) / 8, 0);
+            for (size_t i = 0; i < bits;)
+            {
+                unsigned chunk = static_cast<unsigned>(std::min<size_t>(bits - i, 32));
+                write_bits(block_bits, i, read_bits(payload.data(), offsets[block] + i, chunk), chunk);
+                i += chunk;
+            }
+
+            bytes.insert(bytes.end(), block_bits.begin(), block_bits.end());
+        }
+
+        uint32_t sum = checksum(bytes, bytes.size());
+        for (int i = 0; i < 4; i++)
+            bytes.push_back(static_cast<uint8_t>(sum >> (8 * i)));
+
+        out.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+        if (!out)
+            throw std::runtime_error("Falha ao gravar o PackedSet");
+    }
+
+    /**
+     * @brief Grava o conjunto comprimido no arquivo `path`.
+     */
+    void save(const std::string &path) const
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("Nao foi possivel abrir o arquivo: " + path);
+
+        save(out);
+    }
+
+    /**
+     * @brief Lê um conjunto gravado por `save`.
+     *
+     * O tamanho de cada bloco é calculado a partir da quantidade de chaves do cabeçalho e
+     * da largura do bloco, então nada além do conjunto é consumido: o fluxo fica logo após
+     * o checksum, e outros dados gravados em seguida continuam legíveis.
+     *
+     * @throw std::runtime_error Se o formato, o tipo das chaves ou o checksum não conferirem.
+     */
+    static PackedSet load(std::istream &in)
+    {
+        Input input(in);
+
+        char magic[sizeof(MAGIC)];
+        if (in.rdbuf()->sgetn(magic, sizeof(magic)) != static_cast<std::streamsize>(sizeof(magic)) or
+            std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            in.setstate(std::ios::failbit);
+            throw std::runtime_error("Arquivo nao contem um PackedSet");
+        }
+        input.update(magic, sizeof(magic));
+
+        if (input.varint() != KeyCodec<T>::TYPE_TAG)
+            throw std::runtime_error("Tipo das chaves do arquivo nao corresponde ao PackedSet");
+
+        uint64_t count = input.varint();
+        uint64_t block_size = input.varint();
+        if (block_size != BLOCK_SIZE)
+            throw std::runtime_error("Arquivo de PackedSet com tamanho de bloco nao suportado");
+
+        PackedSet result;
+        result.count = static_cast<size_t>(count);
+        result.payload.clear();
+
+        // Os vetores crescem bloco a bloco, então uma quantidade corrompida falha por
+        // truncamento antes de reservar memória demais
+        size_t blocks = static_cast<size_t>((count + BLOCK_SIZE - 1) / BLOCK_SIZE);
+        size_t bits = 0;
+
+        for (size_t block = 0; block < blocks; block++)
+        {
+            result.bases.push_back(base_from_file(input.varint()));
+            if (block > 0 and !(result.bases[block - 1] < result.bases[block]))
+                throw std::runtime_error("Arquivo de PackedSet corrompido: blocos fora de ordem");
+
+            uint8_t width = input.byte();
+            if (width > std::numeric_limits<U>::digits)
+                throw std::runtime_error("Arquivo de PackedSet corrompido");
+            result.widths.push_back(width);
+
+            size_t block_bits = (result.block_length(block) - 1) * width;
+            size_t block_bytes = (block_bits + 7) / 8;
+
+            // Blocos ficam contíguos em bytes inteiros; as posições em bits refletem isso
+            result.offsets.push_back(bits);
+            result.payload.resize(result.payload.size() + block_bytes);
+            input.read(result.payload.data() + result.payload.size() - block_bytes, block_bytes);
+            bits += block_bytes * 8;
+        }
+
+        uint32_t computed = input.checksum();
+        uint8_t stored_bytes[4];
+        input.raw(stored_bytes, sizeof(stored_bytes));
+
+        uint32_t stored = 0;
+        for (int i = 0; i < 4; i++)
+            stored |= static_cast<uint32_t>(stored_bytes[i]) << (8 * i);
+        if (stored != computed)
+            throw std::runtime_error("Arquivo de PackedSet corrompido: checksum invalido");
+
+        result.payload.insert(result.payload.end(), PADDING, 0);
+
+        return result;
+    }
+
+    /**
+     * @brief Lê um conjunto comprimido do arquivo `path`.
+     */
+    static PackedSet load(const std::string &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("Nao foi possivel abrir o arquivo: " + path);
+
+        return load(in);
+    }
+};
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Cabeçalho do formato binário de `Set::save`/`Set::load` (32 bytes).
+ *
+ * Os campos numéricos são gravados na ordem de bytes nativa da máquina.
+ */
+struct SetFileHeader
+{
+    /**
+     * @brief Identificador do formato e sua versão.
+     */
+    static constexpr char MAGIC[8] = {'A', 'V', 'L', 'S', 'E', 'T', '\0', '\1'};
+
+    char magic[8];
+    uint32_t type_tag; // Ver `KeyCodec<T>::TYPE_TAG`
+    uint32_t flags;    // Reservado, sempre 0
+    uint64_t count;    // Número de chaves
+    uint64_t checksum; // FNV-1a de 64 bits dos bytes das chaves
+};
+
+/**
+ * @brief Hash FNV-1a de 64 bits, calculado de forma incremental.
+ */
+class Fnv1a
+{
+private:
+    uint64_t hash{14695981039346656037ULL};
+
+public:
+    void update(const char *data, size_t size) noexcept
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    uint64_t value() const noexcept
+    {
+        return hash;
+    }
+};
+
+/**
+ * @brief CRC-32 (polinômio 0xEDB88320, o mesmo de zlib e PNG), calculado de forma incremental.
+ */
+class Crc32
+{
+private:
+    static constexpr std::array<uint32_t, 256> TABLE = []
+    {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        return table;
+    }();
+
+    uint32_t crc{0xFFFFFFFFu};
+
+public:
+    void update(const char *data, size_t size) noexcept
+    {
+        for (size_t i = 0; i < size; i++)
+            crc = TABLE[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+
+    uint32_t value() const noexcept
+    {
+        return ~crc;
+    }
+};
+
+/**
+ * @brief Escrita binária com buffer que calcula o checksum dos bytes escritos.
+ *
+ * Sem um `std::ostream`, apenas calcula o checksum (usado na primeira passada do `save`,
+ * já que o checksum fica no cabeçalho, antes das chaves).
+ */
+class BinaryWriter
+{
+private:
+    static constexpr size_t BUFFER_SIZE = 1 << 16;
+
+    std::ostream *out;
+    std::vector<char> buffer;
+    Fnv1a checksum_m;
+
+public:
+    explicit BinaryWriter(std::ostream *out = nullptr) : out(out)
+    {
+        buffer.reserve(BUFFER_SIZE);
+    }
+
+    void write(const void *data, size_t size)
+    {
+        const char *bytes = static_cast<const char *>(data);
+        checksum_m.update(bytes, size);
+
+        if (out == nullptr)
+            return;
+
+        if (buffer.size() + size > BUFFER_SIZE)
+            flush();
+
+        if (size > BUFFER_SIZE)
+            out->write(bytes, size);
+        else
+            buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    void flush()
+    {
+        if (out != nullptr and !buffer.empty())
+            out->write(buffer.data(), buffer.size());
+
+        buffer.clear();
+    }
+
+    uint64_t checksum() const noexcept
+    {
+        return checksum_m.value();
+    }
+};
+
+/**
+ * @brief Leitura binária que calcula o checksum dos bytes lidos.
+ *
+ * Lê direto do `std::streambuf` do fluxo, que já tem seu próprio buffer, e nunca consome
+ * bytes além dos pedidos: depois de decodificar um `Set`, o fluxo fica posicionado logo
+ * após a última chave, e outros dados gravados em seguida continuam legíveis.
+ */
+class BinaryReader
+{
+private:
+    std::istream &in;
+    Fnv1a checksum_m;
+
+public:
+    explicit BinaryReader(std::istream &in) : in(in) {}
+
+    /**
+     * @brief Lê exatamente `size` bytes.
+     *
+     * @throw std::runtime_error Se o fluxo terminar antes.
+     */
+    void read(void *data, size_t size)
+    {
+        char *bytes = static_cast<char *>(data);
+        std::streamsize got = in.rdbuf()->sgetn(bytes, static_cast<std::streamsize>(size));
+
+        if (got != static_cast<std::streamsize>(size))
+        {
+            in.setstate(std::ios::eofbit | std::ios::failbit);
+            throw std::runtime_error("Arquivo de Set truncado");
+        }
+
+        checksum_m.update(bytes, size);
+    }
+
+    uint64_t checksum() const noexcept
+    {
+        return checksum_m.value();
+    }
+};
+
+/**
+ * @brief Codificação binária das chaves de um `Set`.
+ *
+ * Há especializações para tipos trivialmente copiáveis (largura fixa, bytes do próprio
+ * objeto) e para `std::string` (tamanho de 64 bits seguido dos caracteres). Outros tipos
+ * podem ser suportados especializando este template com `TYPE_TAG`, `encode` e `decode`.
+ */
+template <typename T, typename Enable = void>
+struct KeyCodec
+{
+    static_assert(sizeof(T) == 0, "Tipo sem KeyCodec: especialize KeyCodec<T> para serializar este Set");
+};
+
+template <typename T>
+struct KeyCodec<T, std::enable_if_t<std::is_trivially_copyable_v<T>>>
+{
+    /**
+     * @brief Categoria do tipo nos 16 bits altos e `sizeof(T)` nos baixos, para que um
+     * arquivo de `int32_t` não seja lido como `float` ou `int64_t`.
+     */
+    static constexpr uint32_t TYPE_TAG = ((std::is_floating_point_v<T>        ? 3u
+                                           : std::is_integral_v<T> and std::is_signed_v<T> ? 1u
+                                           : std::is_integral_v<T>           ? 2u
+                                                                             : 4u)
+                                          << 16) |
+                                         static_cast<uint32_t>(sizeof(T));
+
+    static void encode(BinaryWriter &writer, const T &key)
+    {
+        writer.write(&key, sizeof(T));
+    }
+
+    static T decode(BinaryReader &reader)
+    {
+        T key;
+        reader.read(&key, sizeof(T));
+        return key;
+    }
+};
+
+template <>
+struct KeyCodec<std::string>
+{
+    static constexpr uint32_t TYPE_TAG = 5u << 16;
+
+    static void encode(BinaryWriter &writer, const std::string &key)
+    {
+        uint64_t size = key.size();
+        writer.write(&size, sizeof(size));
+        writer.write(key.data(), key.size());
+    }
+
+    static std::string decode(BinaryReader &reader)
+    {
+        uint64_t size;
+        reader.read(&size, sizeof(size));
+
+        std::string key;
+        // Lê em partes para que um tamanho corrompido falhe por truncamento, não por memória
+        while (key.size() < size)
+        {
+            size_t chunk = static_cast<size_t>(std::min<uint64_t>(size - key.size(), 1 << 16));
+            size_t old_size = key.size();
+            key.resize(old_size + chunk);
+            reader.read(key.data() + old_size, chunk);
+        }
+
+        return key;
+    }
+};
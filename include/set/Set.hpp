@@ -1,11 +1,31 @@
 #pragma once
 
 #include "node/Node.hpp"
-
+#include "bloomFilter/BloomFilter.hpp"
+#include "serialization/Serialization.hpp"
+#include "bufferedOutput/BufferedWriter.hpp"
+#include "generator/Generator.hpp"
+#include "set/SetStats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <concepts>
+#include <exception>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <initializer_list>
-#include <queue>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <type_traits>
 #include <stack>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 /**
  * @brief Classe que implementa um conjunto dinâmico utilizando uma Árvore AVL.
@@ -15,6 +35,11 @@
  * Isso garante que as operações de busca, inserção e remoção tenham complexidade
  * de tempo O(log n) no pior caso, onde n é o número de elementos no conjunto.
  *
+ * Cópias compartilham a árvore (copy-on-write por subárvore): copiar um conjunto é
+ * O(1) e uma modificação posterior duplica apenas os nós compartilhados do caminho
+ * afetado. Nós compartilhados nunca são escritos, então cópias distintas podem ser
+ * usadas em threads diferentes.
+ *
  * @tparam T Tipo dos elementos armazenados no conjunto. Deve suportar operadores
  *           de comparação ( `<`, `==`, `>`).
  */
@@ -37,6 +62,85 @@ private:
      */
     size_t size_m{0};
 
+    /**
+     * @brief Ponteiro para o nó com a menor chave (nó mais à esquerda), ou `nullptr` se vazio.
+     *
+     * Rotações não alteram a identidade dos nós, então o ponteiro só precisa ser corrigido
+     * quando o próprio nó é removido.
+     */
+    Node<T> *min_node{nullptr};
+
+    /**
+     * @brief Ponteiro para o nó com a maior chave (nó mais à direita), ou `nullptr` se vazio.
+     */
+    Node<T> *max_node{nullptr};
+
+    /**
+     * @brief Filtro de Bloom opcional usado para responder buscas negativas sem percorrer a árvore.
+     *
+     * É `nullptr` enquanto o filtro não for habilitado com `enable_filter`.
+     */
+    std::unique_ptr<BloomFilter<T>> filter_m;
+
+    /**
+     * @brief Contadores de instrumentação deste conjunto (vazios sem `SET_STATS`).
+     */
+    [[no_unique_address]] mutable StatsCounters<> stats_m;
+
+    /**
+     * @brief Contadores da thread atual, somados de todos os conjuntos com elementos `T`.
+     */
+    static StatsCounters<> &thread_counters() noexcept;
+
+    /**
+     * @brief Número de nós visitados pela operação em andamento na thread atual.
+     */
+    static uint64_t &descent_depth() noexcept;
+
+    /**
+     * @brief Soma `n` ao contador nos contadores do conjunto e da thread.
+     */
+    void count(StatsCounter counter, uint64_t n = 1) const noexcept;
+
+    /**
+     * @brief Marca o início de uma operação que desce pela árvore.
+     */
+    void begin_descent() const noexcept;
+
+    /**
+     * @brief Contabiliza um nó visitado na descida e, se `compared`, uma comparação com a sua chave.
+     */
+    void visit_node(bool compared = true) const noexcept;
+
+    /**
+     * @brief Memória alocada fora do nó por uma chave: o buffer de uma `std::string` fora
+     * da otimização de strings curtas, o de um `std::vector`, etc.
+     */
+    static size_t key_heap_bytes(const T &key) noexcept;
+
+    /**
+     * @brief Função auxiliar recursiva de `shape_stats`: acumula `node` e sua subárvore.
+     *
+     * @param node Raiz da subárvore.
+     * @param depth Profundidade de `node` (0 na raiz).
+     * @param stats Estatísticas acumuladas.
+     * @param path_sum Soma dos comprimentos de caminho até cada nó.
+     */
+    void shape_stats(NodePtr node, size_t depth, ShapeStats &stats, size_t &path_sum) const;
+
+    /**
+     * @brief Reconstrói o filtro de Bloom a partir das chaves atualmente na árvore.
+     *
+     * Chamado de forma preguiçosa quando o filtro acumula remoções demais ou cresce além
+     * da capacidade planejada.
+     */
+    void rebuild_filter();
+
+    /**
+     * @brief Adiciona ao filtro de Bloom todas as chaves presentes na árvore.
+     */
+    void fill_filter();
+
     /**
      * @brief Realiza o balanceamento da árvore AVL após uma inserção ou remoção.
      *
@@ -55,11 +159,15 @@ private:
      * Percorre a árvore para encontrar a posição correta de inserção da chave.
      * Após a inserção, chama `fixup_node` para garantir o balanceamento da AVL.
      *
+     * Ao encontrar um nó compartilhado, verifica antes se a chave já existe na
+     * subárvore, para não copiar o caminho à toa; a partir daí `absent` é `true`.
+     *
      * @param p Ponteiro para o nó raiz da subárvore onde a chave será inserida.
      * @param key A chave a ser inserida.
+     * @param absent Indica que já se sabe que a chave não está na subárvore.
      * @return NodePtr Ponteiro para a raiz da subárvore modificada.
      */
-    Node<T> *insert(NodePtr p, const T &key);
+    Node<T> *insert(NodePtr p, const T &key, bool absent = false);
 
     /**
      * @brief Realiza o balanceamento da árvore AVL após uma remoção.
@@ -80,11 +188,15 @@ private:
      * folha, nó com um filho ou nó com dois filhos (neste caso, substituindo
      * pelo sucessor). Após a remoção, chama `fixup_deletion` para balancear a árvore.
      *
+     * Assim como `insert`, só copia nós compartilhados depois de confirmar que a
+     * chave está na subárvore (`present`).
+     *
      * @param p Ponteiro para o nó raiz da subárvore de onde a chave será removida.
      * @param key A chave a ser removida.
+     * @param present Indica que já se sabe que a chave está na subárvore.
      * @return NodePtr Ponteiro para a raiz da subárvore modificada.
      */
-    Node<T> *remove(NodePtr p, const T &key);
+    Node<T> *remove(NodePtr p, const T &key, bool present = false);
 
     /**
      * @brief Remove o nó sucessor de um dado nó e o retorna.
@@ -102,13 +214,102 @@ private:
     /**
      * @brief Função auxiliar recursiva para remover todos os nós da árvore.
      *
-     * Realiza um percurso em pós-ordem para deletar todos os nós.
+     * Realiza um percurso em pós-ordem liberando a referência a cada nó; apenas os
+     * nós que não são compartilhados com outras cópias são deletados.
      *
      * @param root Ponteiro para o nó raiz da subárvore a ser limpa.
      * @return NodePtr Sempre retorna `nullptr` após limpar a subárvore.
      */
     Node<T> *clear(NodePtr root);
 
+    /**
+     * @brief Verifica se um nó é referenciado por mais de um pai ou conjunto.
+     */
+    static bool shared(NodePtr node) noexcept;
+
+    /**
+     * @brief Adiciona uma referência a um nó (ou não faz nada se for `nullptr`).
+     */
+    static void retain(NodePtr node) noexcept;
+
+    /**
+     * @brief Garante que `p` pertence exclusivamente a este conjunto.
+     *
+     * Se `p` estiver compartilhado, cria uma cópia que referencia os mesmos filhos e
+     * transfere para ela a referência do chamador. Deve ser chamada de cima para baixo:
+     * o pai de `p` já precisa ser exclusivo. Atualiza `min_node`/`max_node` se necessário.
+     *
+     * @param p Ponteiro para o nó a ser descompartilhado.
+     * @return NodePtr O próprio `p`, se exclusivo, ou a sua cópia.
+     */
+    Node<T> *unshare(NodePtr p);
+
+    /**
+     * @brief Remove o nó com a menor chave da subárvore `p`, rebalanceando o caminho.
+     *
+     * @param p Ponteiro para a raiz da subárvore (não pode ser `nullptr`).
+     * @return NodePtr Ponteiro para a raiz da subárvore modificada.
+     */
+    Node<T> *remove_min(NodePtr p);
+
+    /**
+     * @brief Remove o nó com a maior chave da subárvore `p`, rebalanceando o caminho.
+     *
+     * @param p Ponteiro para a raiz da subárvore (não pode ser `nullptr`).
+     * @return NodePtr Ponteiro para a raiz da subárvore modificada.
+     */
+    Node<T> *remove_max(NodePtr p);
+
+    /**
+     * @brief Recalcula `min_node`/`max_node` que foram invalidados por uma remoção.
+     *
+     * Percorre apenas a espinha esquerda e/ou direita, em O(log n).
+     */
+    void refresh_extremes();
+
+    /**
+     * @brief Contabiliza uma remoção no filtro de Bloom, reconstruindo-o se necessário.
+     */
+    void note_filter_erase();
+
+    /**
+     * @brief Tamanho mínimo de um trecho para que valha a pena processá-lo em outra thread.
+     */
+    static constexpr size_t PARALLEL_GRAIN = 1 << 14;
+
+    /**
+     * @brief Constrói uma subárvore perfeitamente balanceada com as `n` chaves ordenadas e
+     * distintas a partir de `keys`, em O(n).
+     *
+     * A chave do meio vira a raiz e as metades viram as subárvores; enquanto houver mais de
+     * uma thread disponível, a subárvore esquerda é construída em uma nova thread.
+     * Se algo lançar (alocação, cópia de uma chave, criação de thread), todas as threads
+     * terminam, os nós já alocados são liberados e a exceção é repassada.
+     *
+     * @param keys Ponteiro para a primeira chave.
+     * @param n Número de chaves.
+     * @param threads Número de threads que podem trabalhar nesta subárvore.
+     * @return NodePtr Ponteiro para a raiz da subárvore construída.
+     */
+    static Node<T> *build_sorted(const T *keys, size_t n, unsigned threads);
+
+    /**
+     * @brief Libera uma subárvore recém-montada por `build_sorted`, ainda não ligada a
+     * nenhum conjunto (todos os nós exclusivos e fora das estatísticas).
+     */
+    static void free_built(NodePtr node) noexcept;
+
+    /**
+     * @brief Ordena `keys` com `threads` threads: cada uma ordena um trecho e os trechos
+     * são intercalados dois a dois, em rodadas paralelas.
+     */
+    static void parallel_sort(std::vector<T> &keys, unsigned threads);
+
+    /**
+     * @brief Substitui o conteúdo do conjunto pelas chaves ordenadas e distintas de `keys`, em O(n).
+     */
+    void assign_sorted(const std::vector<T> &keys, unsigned threads = 1);
+
     /**
      * @brief Atualiza a altura de um nó.
      *
@@ -144,6 +345,8 @@ private:
      *
      * Usada para balancear a árvore quando ela está desbalanceada à esquerda.
      *
+     * Os dois nós que mudam de posição são descompartilhados antes de serem modificados.
+     *
      * @param p Ponteiro para o nó que será a raiz da rotação (o nó desbalanceado).
      * @return NodePtr Ponteiro para a nova raiz da subárvore após a rotação.
      */
@@ -154,6 +357,8 @@ private:
      *
      * Usada para balancear a árvore quando ela está desbalanceada à direita.
      *
+     * Os dois nós que mudam de posição são descompartilhados antes de serem modificados.
+     *
      * @param p Ponteiro para o nó que será a raiz da rotação (o nó desbalanceado).
      * @return NodePtr Ponteiro para a nova raiz da subárvore após a rotação.
      */
@@ -169,6 +374,14 @@ private:
      */
     bool contains(NodePtr root, const T &key) const;
 
+    /**
+     * @brief Busca `key` na subárvore `p` sem contabilizar estatísticas.
+     *
+     * Usada na verificação prévia do copy-on-write em `insert` e `remove`, para que a
+     * descida extra não entre nas comparações nem em `max_depth`.
+     */
+    static bool subtree_contains(NodePtr p, const T &key);
+
     /**
      * @brief Insere todos os elementos da subárvore rooted em `node` no conjunto `result`.
      *
@@ -181,42 +394,47 @@ private:
     void insertUnion(Set<T> &result, const NodePtr &node) const;
 
     /**
-     * @brief Função auxiliar recursiva para imprimir os elementos em ordem (in-order).
-     *
-     * @param node Ponteiro para o nó raiz da subárvore a ser impressa.
+     * @brief Limite da altura de uma árvore AVL com até 2^64 nós (cerca de 1,44 log2 n),
+     * usado como capacidade das pilhas fixas das travessias.
      */
-    void printInOrder(NodePtr node);
+    static constexpr size_t MAX_HEIGHT = 96;
 
     /**
-     * @brief Função auxiliar recursiva para imprimir os elementos em pré-ordem (pre-order).
-     *
-     * @param node Ponteiro para o nó raiz da subárvore a ser impressa.
+     * @brief Chama `f(key)`; retorna `false` apenas se `f` retornar `bool` e pedir a parada.
      */
-    void printPreOrder(NodePtr node);
+    template <typename F>
+    static bool visit(F &f, const T &key);
 
     /**
-     * @brief Função auxiliar recursiva para imprimir os elementos em pós-ordem (post-order).
-     *
-     * @param node Ponteiro para o nó raiz da subárvore a ser impressa.
+     * @brief Visitante que escreve cada chave seguida de um espaço em `writer`.
      */
-    void printPostOrder(NodePtr node);
+    template <class Sink>
+    static auto key_printer(BufferedWriter<Sink> &writer);
 
     /**
-     * @brief Função auxiliar recursiva para imprimir os elementos em formato "grande".
-     *
-     * Provavelmente imprime os elementos em ordem decrescente (reverse in-order).
+     * @brief Estado compartilhado pelas chamadas de `bshow` durante uma exibição.
      *
-     * @param node Ponteiro para o nó raiz da subárvore a ser impressa.
+     * `prefix` é a única pilha de prefixos: cada nível acrescenta seu trecho de
+     * indentação ao descer e o remove ao voltar.
      */
-    void printLarge(NodePtr node);
+    struct BshowState
+    {
+        BufferedWriter<std::ostream *> &writer;
+        std::string prefix;
+        size_t max_depth;
+        size_t max_nodes;
+        size_t shown{0};
+    };
 
     /**
      * @brief Função auxiliar recursiva para exibir a estrutura da árvore.
      *
      * @param node Ponteiro para o nó raiz da subárvore a ser exibida.
-     * @param heranca String usada para formatar a indentação e mostrar a hierarquia.
+     * @param depth Profundidade de `node` (0 na raiz).
+     * @param direction 'r' ou 'l' conforme `node` seja filho direito ou esquerdo ('\0' na raiz).
+     * @param state Saída, prefixo atual e limites da exibição.
      */
-    void bshow(NodePtr node, std::string heranca);
+    void bshow(NodePtr node, size_t depth, char direction, BshowState &state) const;
 
 public:
     /**
@@ -227,7 +445,8 @@ public:
     /**
      * @brief Construtor de cópia. Cria um novo conjunto como cópia de `other`.
      *
-     * Realiza uma cópia profunda dos elementos.
+     * Executa em O(1): a árvore é compartilhada e só é duplicada, caminho a caminho,
+     * quando uma das cópias for modificada. O filtro de Bloom, se houver, é copiado.
      *
      * @param other O conjunto a ser copiado.
      */
@@ -250,8 +469,8 @@ public:
     /**
      * @brief Operador de atribuição por cópia.
      *
-     * Substitui o conteúdo do conjunto atual pelo conteúdo de `other`.
-     * Garante a autotribuição segura e libera a memória antiga antes de copiar.
+     * Substitui o conteúdo do conjunto atual pelo conteúdo de `other`, compartilhando
+     * sua árvore em O(1). Garante a autotribuição segura e libera a memória antiga.
      *
      * @param other O conjunto a ser copiado.
      */
@@ -320,6 +539,8 @@ public:
     /**
      * @brief Retorna o menor elemento no conjunto.
      *
+     * Executa em O(1), pois o nó mínimo é mantido em cache.
+     *
      * @return T O menor elemento.
      * @throw std::out_of_range Se o conjunto estiver vazio.
      */
@@ -328,11 +549,45 @@ public:
     /**
      * @brief Retorna o maior elemento no conjunto.
      *
+     * Executa em O(1), pois o nó máximo é mantido em cache.
+     *
      * @return T O maior elemento.
      * @throw std::out_of_range Se o conjunto estiver vazio.
      */
     T maximum() const;
 
+    /**
+     * @brief Retorna o menor elemento, sem lançar exceção.
+     *
+     * @return std::optional<T> O menor elemento, ou `std::nullopt` se o conjunto estiver vazio.
+     */
+    std::optional<T> try_min() const noexcept(std::is_nothrow_copy_constructible_v<T>);
+
+    /**
+     * @brief Retorna o maior elemento, sem lançar exceção.
+     *
+     * @return std::optional<T> O maior elemento, ou `std::nullopt` se o conjunto estiver vazio.
+     */
+    std::optional<T> try_max() const noexcept(std::is_nothrow_copy_constructible_v<T>);
+
+    /**
+     * @brief Remove e retorna o menor elemento do conjunto em O(log n).
+     *
+     * Permite usar o conjunto como uma fila de prioridade ordenada.
+     *
+     * @return T O menor elemento, que deixa de pertencer ao conjunto.
+     * @throw std::runtime_error Se o conjunto estiver vazio.
+     */
+    T pop_min();
+
+    /**
+     * @brief Remove e retorna o maior elemento do conjunto em O(log n).
+     *
+     * @return T O maior elemento, que deixa de pertencer ao conjunto.
+     * @throw std::runtime_error Se o conjunto estiver vazio.
+     */
+    T pop_max();
+
     /**
      * @brief Retorna o sucessor de uma chave no conjunto.
      *
@@ -357,6 +612,93 @@ public:
      */
     T predecessor(const T &key) const;
 
+    /**
+     * @brief Retorna o menor elemento do conjunto estritamente maior que `key`, sem lançar exceção.
+     *
+     * Ao contrário de `successor`, funciona também para chaves que não pertencem ao conjunto.
+     *
+     * @param key A chave de referência.
+     * @return std::optional<T> O próximo elemento, ou `std::nullopt` se não houver.
+     */
+    std::optional<T> find_next(const T &key) const noexcept(std::is_nothrow_copy_constructible_v<T>);
+
+    /**
+     * @brief Retorna o maior elemento do conjunto estritamente menor que `key`, sem lançar exceção.
+     *
+     * Ao contrário de `predecessor`, funciona também para chaves que não pertencem ao conjunto.
+     *
+     * @param key A chave de referência.
+     * @return std::optional<T> O elemento anterior, ou `std::nullopt` se não houver.
+     */
+    std::optional<T> find_prev(const T &key) const noexcept(std::is_nothrow_copy_constructible_v<T>);
+
+    /**
+     * @brief Chama `f(chave)` para cada elemento do conjunto, em ordem crescente.
+     *
+     * @param f A função a ser aplicada a cada elemento.
+     */
+    template <typename F>
+    void for_each(F f) const;
+
+    // Travessias genéricas
+
+    /**
+     * @brief Chama `f(chave)` para cada elemento em ordem (in-order: Esquerda, Raiz, Direita).
+     *
+     * As travessias são iterativas, com uma pilha de capacidade fixa (`MAX_HEIGHT`) na
+     * própria pilha de execução, e não alocam memória. Se `f` retornar `bool`, retornar
+     * `false` interrompe a travessia.
+     *
+     * @return `true` se todos os elementos foram visitados, `false` se `f` interrompeu.
+     */
+    template <typename F>
+    bool for_each_inorder(F &&f) const;
+
+    /**
+     * @brief Como `for_each_inorder`, em pré-ordem (Raiz, Esquerda, Direita).
+     */
+    template <typename F>
+    bool for_each_preorder(F &&f) const;
+
+    /**
+     * @brief Como `for_each_inorder`, em pós-ordem (Esquerda, Direita, Raiz).
+     */
+    template <typename F>
+    bool for_each_postorder(F &&f) const;
+
+    /**
+     * @brief Como `for_each_inorder`, por nível (da raiz para as folhas, da esquerda para a direita).
+     *
+     * Sem fila: cada nível é percorrido em profundidade a partir da raiz, ignorando
+     * subárvores que não alcançam o nível. Como a árvore é balanceada, o custo total
+     * continua O(n).
+     */
+    template <typename F>
+    bool for_each_levelorder(F &&f) const;
+
+    // Geradores preguiçosos (corrotinas)
+
+    /**
+     * @brief Gera os elementos em ordem crescente, um de cada vez, sob demanda.
+     *
+     * Os geradores guardam apenas uma pilha de altura fixa no quadro da corrotina e
+     * acessam os nós do conjunto, que deve continuar existindo e não ser modificado
+     * enquanto o gerador estiver em uso.
+     */
+    Generator<T> inorder() const;
+
+    /**
+     * @brief Gera os elementos por nível, na mesma ordem de `for_each_levelorder`.
+     */
+    Generator<T> levelorder() const;
+
+    /**
+     * @brief Gera, em ordem crescente, os elementos `k` com `low <= k <= high`.
+     *
+     * Desce direto até `low` em O(log n) e termina ao passar de `high`.
+     */
+    Generator<T> range(T low, T high) const;
+
     /**
      * @brief Retorna um novo conjunto que é a união deste conjunto com `other`.
      *
@@ -411,36 +753,196 @@ public:
      */
     Set operator-(const Set &other) const;
 
+    /**
+     * @brief Constrói um conjunto a partir de uma coleção grande e não ordenada usando várias threads.
+     *
+     * As chaves são copiadas, ordenadas em paralelo (ordenação de trechos seguida de
+     * intercalação em rodadas), deduplicadas e a árvore balanceada é montada em O(n)
+     * com as subárvores construídas concorrentemente. É muito mais rápido que inserir
+     * as chaves uma a uma.
+     *
+     * @param range Qualquer coleção com `std::begin`/`std::end` cujos elementos sejam `T`.
+     * @param threads Número de threads a usar; 0 equivale a 1.
+     * @return Set<T> O conjunto com as chaves distintas de `range`.
+     */
+    template <typename Range>
+    static Set build_parallel(const Range &range, unsigned threads = std::thread::hardware_concurrency());
+
+    /**
+     * @brief Constrói um conjunto a partir de chaves já ordenadas e distintas, em O(n) e
+     * sem rotações.
+     *
+     * @param keys Chaves em ordem estritamente crescente.
+     * @param threads Número de threads a usar na montagem; 0 equivale a 1.
+     * @throw std::invalid_argument Se `keys` não estiver em ordem estritamente crescente.
+     */
+    static Set from_sorted(const std::vector<T> &keys, unsigned threads = 1);
+
+    // Serialização binária
+
+    /**
+     * @brief Grava o conjunto em formato binário compacto.
+     *
+     * O formato é um cabeçalho (`SetFileHeader`: identificador, tipo das chaves, quantidade
+     * e checksum) seguido das chaves em ordem crescente, codificadas por `KeyCodec<T>`:
+     * largura fixa para tipos trivialmente copiáveis e tamanho + bytes para `std::string`.
+     *
+     * @param out O fluxo de saída, que deve estar em modo binário.
+     * @throw std::runtime_error Se a escrita falhar.
+     */
+    void save(std::ostream &out) const;
+
+    /**
+     * @brief Grava o conjunto no arquivo `path`, substituindo seu conteúdo.
+     *
+     * @throw std::runtime_error Se o arquivo não puder ser aberto ou escrito.
+     */
+    void save(const std::string &path) const;
+
+    /**
+     * @brief Substitui o conteúdo do conjunto pelo lido de um fluxo gravado por `save`.
+     *
+     * As chaves já estão ordenadas, então a árvore é montada em O(n), sem rotações.
+     * Nada além do conjunto é consumido: o fluxo fica logo após a última chave, então
+     * vários conjuntos (ou outros dados) podem ser gravados em sequência no mesmo fluxo.
+     * Em caso de erro, o conjunto não é modificado.
+     *
+     * @param in O fluxo de entrada, que deve estar em modo binário.
+     * @throw std::runtime_error Se o formato, o tipo das chaves ou o checksum não conferirem,
+     *                           ou se o fluxo terminar antes do esperado.
+     */
+    void load(std::istream &in);
+
+    /**
+     * @brief Substitui o conteúdo do conjunto pelo lido do arquivo `path`.
+     *
+     * @throw std::runtime_error Se o arquivo não puder ser aberto ou for inválido.
+     */
+    void load(const std::string &path);
+
     // Funções de impressão
 
     /**
      * @brief Imprime os elementos do conjunto em ordem crescente (in-order traversal).
+     *
+     * Cada chave é seguida de um espaço. As versões com `out` escrevem no fluxo ou no
+     * iterador de saída informado, formatando com `BufferedWriter` e enviando o texto
+     * em blocos grandes; a versão sem argumentos escreve em `std::cout`.
      */
-    void printInOrder();
+    void printInOrder() const;
+    void printInOrder(std::ostream &out) const;
+    template <std::output_iterator<char> OutputIt>
+    OutputIt printInOrder(OutputIt out) const;
 
     /**
      * @brief Imprime os elementos do conjunto em pré-ordem (pre-order traversal).
      * (Raiz, Esquerda, Direita)
      */
-    void printPreOrder();
+    void printPreOrder() const;
+    void printPreOrder(std::ostream &out) const;
+    template <std::output_iterator<char> OutputIt>
+    OutputIt printPreOrder(OutputIt out) const;
 
     /**
      * @brief Imprime os elementos do conjunto em pós-ordem (post-order traversal).
      * (Esquerda, Direita, Raiz)
      */
-    void printPostOrder();
+    void printPostOrder() const;
+    void printPostOrder(std::ostream &out) const;
+    template <std::output_iterator<char> OutputIt>
+    OutputIt printPostOrder(OutputIt out) const;
 
     /**
      * @brief Imprime os elementos do conjunto com base na altura de cada, será imprimida por nível.
      */
-    void printLarge();
+    void printLarge() const;
+    void printLarge(std::ostream &out) const;
+    template <std::output_iterator<char> OutputIt>
+    OutputIt printLarge(OutputIt out) const;
 
     /**
      * @brief Exibe a estrutura da árvore AVL de forma visual no console.
      *
      * Útil para depuração e visualização do balanceamento da árvore.
      */
-    void bshow();
+    void bshow() const;
+
+    /**
+     * @brief Exibe a estrutura da árvore em `out`, com limites opcionais.
+     *
+     * A saída é escrita com `BufferedWriter`, e a indentação é mantida em um único
+     * prefixo reaproveitado por todas as linhas, então o custo é proporcional ao texto
+     * gerado. Um nó cujos filhos ficam além de `max_depth` é exibido com " ..."; ao
+     * atingir `max_nodes` nós exibidos, a exibição termina com uma linha "...".
+     *
+     * @param out Fluxo de saída.
+     * @param max_depth Profundidade máxima exibida (a raiz tem profundidade 0).
+     * @param max_nodes Número máximo de nós exibidos.
+     */
+    void bshow(std::ostream &out, size_t max_depth = SIZE_MAX, size_t max_nodes = SIZE_MAX) const;
+
+    // Filtro de Bloom para buscas negativas
+
+    /**
+     * @brief Habilita um filtro de Bloom que acelera `contains` para chaves ausentes.
+     *
+     * O filtro é mantido a cada `insert` e reconstruído de forma preguiçosa depois de
+     * remoções suficientes. Se já existir um filtro, ele é recriado com o novo dimensionamento.
+     *
+     * @param bits_per_key Bits por chave; 10 bits resulta em cerca de 1% de falsos positivos.
+     */
+    void enable_filter(double bits_per_key = 10.0);
+
+    /**
+     * @brief Remove o filtro de Bloom, liberando sua memória.
+     */
+    void disable_filter() noexcept;
+
+    /**
+     * @brief Verifica se o conjunto possui um filtro de Bloom habilitado.
+     */
+    bool has_filter() const noexcept;
+
+    /**
+     * @brief Retorna as estatísticas do filtro (taxa de falsos positivos, reconstruções, etc.).
+     *
+     * @return BloomFilterStats As estatísticas do filtro.
+     * @throw std::runtime_error Se o filtro não estiver habilitado.
+     */
+    BloomFilterStats filter_stats() const;
+
+    /**
+     * @brief Retorna os contadores de instrumentação deste conjunto (ver `SetStats`).
+     *
+     * Só há contagem quando o código é compilado com `-DSET_STATS`; sem a macro o
+     * resultado é sempre zerado. Cópias do conjunto começam com os contadores zerados.
+     */
+    SetStats stats() const noexcept;
+
+    /**
+     * @brief Zera os contadores de instrumentação deste conjunto.
+     */
+    void reset_stats() noexcept;
+
+    /**
+     * @brief Retorna os contadores de instrumentação da thread atual, somados de todos os
+     * conjuntos com elementos `T` usados por ela.
+     */
+    static SetStats thread_stats() noexcept;
+
+    /**
+     * @brief Zera os contadores de instrumentação da thread atual.
+     */
+    static void reset_thread_stats() noexcept;
+
+    /**
+     * @brief Calcula a forma da árvore e estima a memória ocupada pelo conjunto (ver `ShapeStats`).
+     *
+     * Percorre todos os nós uma vez, em O(n), sem alocar além do histograma de profundidades.
+     *
+     * @return ShapeStats Altura, histograma de profundidades, fatores de balanceamento e memória estimada.
+     */
+    ShapeStats shape_stats() const;
 };
 
 // -------------------------------------------Implementação da classe Set.------------------------------------------------------------------
@@ -453,9 +955,13 @@ Set<T>::Set(std::initializer_list<T> list) : Set()
 }
 
 template <class T>
-Set<T>::Set(const Set &other) : Set()
+Set<T>::Set(const Set &other)
+    : root(other.root), size_m(other.size_m), min_node(other.min_node), max_node(other.max_node)
 {
-    insertUnion(*this, other.root);
+    retain(root);
+
+    if (other.filter_m)
+        filter_m = std::make_unique<BloomFilter<T>>(*other.filter_m);
 }
 
 template <class T>
@@ -470,7 +976,16 @@ void Set<T>::operator=(const Set &other)
     if (this != &other)
     {
         clear();
-        insertUnion(*this, other.root);
+
+        root = other.root;
+        size_m = other.size_m;
+        min_node = other.min_node;
+        max_node = other.max_node;
+        retain(root);
+
+        filter_m.reset();
+        if (other.filter_m)
+            filter_m = std::make_unique<BloomFilter<T>>(*other.filter_m);
     }
 }
 
@@ -489,16 +1004,50 @@ bool Set<T>::empty() const noexcept
 template <class T>
 Node<T> *Set<T>::clear(NodePtr root)
 {
-    if (root != nullptr)
+    if (root != nullptr and root->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
     {
         root->left = clear(root->left);
         root->right = clear(root->right);
 
         delete root;
-        return nullptr;
+        count(StatsCounter::Frees);
     }
 
-    return root;
+    return nullptr;
+}
+
+template <class T>
+bool Set<T>::shared(NodePtr node) noexcept
+{
+    return node->refs.load(std::memory_order_acquire) != 1;
+}
+
+template <class T>
+void Set<T>::retain(NodePtr node) noexcept
+{
+    if (node != nullptr)
+        node->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <class T>
+Node<T> *Set<T>::unshare(NodePtr p)
+{
+    if (!shared(p))
+        return p;
+
+    NodePtr copy = new Node<T>(p->key, p->height, p->left, p->right);
+    count(StatsCounter::Allocations);
+    retain(copy->left);
+    retain(copy->right);
+
+    if (p == min_node)
+        min_node = copy;
+    if (p == max_node)
+        max_node = copy;
+
+    clear(p);
+
+    return copy;
 }
 
 template <class T>
@@ -506,6 +1055,10 @@ void Set<T>::clear()
 {
     root = clear(root);
     size_m = 0;
+    min_node = max_node = nullptr;
+
+    if (filter_m)
+        filter_m->clear();
 }
 
 template <class T>
@@ -513,6 +1066,9 @@ void Set<T>::swap(Set<T> &other)
 {
     std::swap(root, other.root);
     std::swap(size_m, other.size_m);
+    std::swap(min_node, other.min_node);
+    std::swap(max_node, other.max_node);
+    std::swap(filter_m, other.filter_m);
 }
 
 template <class T>
@@ -524,19 +1080,23 @@ Node<T> *Set<T>::fixup_node(NodePtr p)
 
     if (bal == -2 and height(p->left->left) > height(p->left->right))
     {
+        count(StatsCounter::SingleRotations);
         return rightRotation(p);
     }
     else if (bal == -2 and height(p->left->left) < height(p->left->right))
     {
+        count(StatsCounter::DoubleRotations);
         p->left = leftRotation(p->left);
         return rightRotation(p);
     }
     else if (bal == 2 and height(p->right->right) > height(p->right->left))
     {
+        count(StatsCounter::SingleRotations);
         return leftRotation(p);
     }
     else if (bal == 2 and height(p->right->right) < height(p->right->left))
     {
+        count(StatsCounter::DoubleRotations);
         p->right = rightRotation(p->right);
         return leftRotation(p);
     }
@@ -545,20 +1105,40 @@ Node<T> *Set<T>::fixup_node(NodePtr p)
 }
 
 template <class T>
-Node<T> *Set<T>::insert(NodePtr p, const T &key)
+Node<T> *Set<T>::insert(NodePtr p, const T &key, bool absent)
 {
     if (p == nullptr)
     {
         size_m++;
-        return new Node<T>(key);
+        NodePtr node = new Node<T>(key);
+        count(StatsCounter::Allocations);
+
+        if (min_node == nullptr or key < min_node->key)
+            min_node = node;
+        if (max_node == nullptr or key > max_node->key)
+            max_node = node;
+
+        return node;
     }
 
+    visit_node();
+
     if (key == p->key)
         return p;
-    else if (key < p->key)
-        p->left = insert(p->left, key);
+
+    if (shared(p))
+    {
+        if (!absent and subtree_contains(p, key))
+            return p;
+
+        absent = true;
+        p = unshare(p);
+    }
+
+    if (key < p->key)
+        p->left = insert(p->left, key, absent);
     else
-        p->right = insert(p->right, key);
+        p->right = insert(p->right, key, absent);
 
     p = fixup_node(p);
 
@@ -568,13 +1148,67 @@ Node<T> *Set<T>::insert(NodePtr p, const T &key)
 template <class T>
 void Set<T>::insert(const T &key)
 {
+    begin_descent();
+    size_t old_size = size_m;
     root = insert(root, key);
+
+    if (filter_m and size_m != old_size)
+    {
+        filter_m->add(key);
+
+        if (filter_m->needs_rebuild(size_m))
+            rebuild_filter();
+    }
 }
 
 template <class T>
 void Set<T>::erase(const T &key)
 {
+    begin_descent();
+    size_t old_size = size_m;
     root = remove(root, key);
+
+    if (size_m != old_size)
+    {
+        refresh_extremes();
+        note_filter_erase();
+    }
+}
+
+template <class T>
+void Set<T>::note_filter_erase()
+{
+    if (!filter_m)
+        return;
+
+    filter_m->note_erase();
+
+    if (filter_m->needs_rebuild(size_m))
+        rebuild_filter();
+}
+
+template <class T>
+void Set<T>::refresh_extremes()
+{
+    if (root == nullptr)
+    {
+        min_node = max_node = nullptr;
+        return;
+    }
+
+    if (min_node == nullptr)
+    {
+        min_node = root;
+        while (min_node->left != nullptr)
+            min_node = min_node->left;
+    }
+
+    if (max_node == nullptr)
+    {
+        max_node = root;
+        while (max_node->right != nullptr)
+            max_node = max_node->right;
+    }
 }
 
 template <class T>
@@ -583,19 +1217,27 @@ Node<T> *Set<T>::fixup_deletion(NodePtr p)
     int bal = balance(p);
 
     if (bal == 2 and balance(p->right) >= 0)
+    {
+        count(StatsCounter::SingleRotations);
         return leftRotation(p);
+    }
 
     if (bal == 2 and balance(p->right) < 0)
     {
+        count(StatsCounter::DoubleRotations);
         p->right = rightRotation(p->right);
         return leftRotation(p);
     }
 
     if (bal == -2 and balance(p->left) <= 0)
+    {
+        count(StatsCounter::SingleRotations);
         return rightRotation(p);
+    }
 
     if (bal == -2 and balance(p->left) > 0)
     {
+        count(StatsCounter::DoubleRotations);
         p->left = leftRotation(p->left);
         return rightRotation(p);
     }
@@ -606,19 +1248,37 @@ Node<T> *Set<T>::fixup_deletion(NodePtr p)
 }
 
 template <class T>
-Node<T> *Set<T>::remove(NodePtr p, const T &key)
+Node<T> *Set<T>::remove(NodePtr p, const T &key, bool present)
 {
     if (p == nullptr)
         return p;
 
+    visit_node();
+
+    if (shared(p))
+    {
+        if (!present and !subtree_contains(p, key))
+            return p;
+
+        present = true;
+        p = unshare(p);
+    }
+
     if (key < p->key)
-        p->left = remove(p->left, key);
+        p->left = remove(p->left, key, present);
     else if (key > p->key)
-        p->right = remove(p->right, key);
+        p->right = remove(p->right, key, present);
     else if (p->right == nullptr)
     {
         NodePtr child = p->left;
+
+        if (p == min_node)
+            min_node = nullptr;
+        if (p == max_node)
+            max_node = nullptr;
+
         delete p;
+        count(StatsCounter::Frees);
         size_m--;
         return child;
     }
@@ -633,13 +1293,21 @@ Node<T> *Set<T>::remove(NodePtr p, const T &key)
 template <class T>
 Node<T> *Set<T>::remove_successor(NodePtr root, NodePtr node)
 {
+    node = unshare(node);
+    visit_node(false);
+
     if (node->left != nullptr)
         node->left = remove_successor(root, node->left);
     else
     {
         root->key = node->key;
         NodePtr aux = node->right;
+
+        if (node == max_node)
+            max_node = root;
+
         delete node;
+        count(StatsCounter::Frees);
         size_m--;
         return aux;
     }
@@ -670,7 +1338,9 @@ int Set<T>::balance(NodePtr node)
 template <class T>
 Node<T> *Set<T>::rightRotation(NodePtr p)
 {
-    NodePtr aux = p->left;
+    count(StatsCounter::RightRotations);
+    p = unshare(p);
+    NodePtr aux = unshare(p->left);
     p->left = aux->right;
     aux->right = p;
 
@@ -683,7 +1353,9 @@ Node<T> *Set<T>::rightRotation(NodePtr p)
 template <class T>
 Node<T> *Set<T>::leftRotation(NodePtr p)
 {
-    NodePtr aux = p->right;
+    count(StatsCounter::LeftRotations);
+    p = unshare(p);
+    NodePtr aux = unshare(p->right);
     p->right = aux->left;
     aux->left = p;
 
@@ -699,6 +1371,8 @@ bool Set<T>::contains(NodePtr root, const T &key) const
     if (root == nullptr)
         return false;
 
+    visit_node();
+
     if (key == root->key)
         return true;
     else if (key < root->key)
@@ -707,10 +1381,36 @@ bool Set<T>::contains(NodePtr root, const T &key) const
         return contains(root->right, key);
 }
 
+template <class T>
+bool Set<T>::subtree_contains(NodePtr p, const T &key)
+{
+    while (p != nullptr)
+    {
+        if (key == p->key)
+            return true;
+
+        p = (key < p->key) ? p->left : p->right;
+    }
+
+    return false;
+}
+
 template <class T>
 bool Set<T>::contains(const T &key) const
 {
-    return contains(root, key);
+    begin_descent();
+
+    if (!filter_m)
+        return contains(root, key);
+
+    if (!filter_m->may_contain(key))
+        return false;
+
+    bool found = contains(root, key);
+    if (!found)
+        filter_m->record_false_positive();
+
+    return found;
 }
 
 template <class T>
@@ -719,11 +1419,7 @@ T Set<T>::minimum() const
     if (root == nullptr)
         throw std::runtime_error("Nao ha elementos no Set");
 
-    NodePtr aux = root;
-    while (aux->left != nullptr)
-        aux = aux->left;
-
-    return aux->key;
+    return min_node->key;
 }
 
 template <class T>
@@ -732,11 +1428,109 @@ T Set<T>::maximum() const
     if (root == nullptr)
         throw std::runtime_error("Nao ha elementos no Set");
 
-    NodePtr aux = root;
-    while (aux->right != nullptr)
-        aux = aux->right;
+    return max_node->key;
+}
+
+template <class T>
+std::optional<T> Set<T>::try_min() const noexcept(std::is_nothrow_copy_constructible_v<T>)
+{
+    if (min_node == nullptr)
+        return std::nullopt;
+
+    return min_node->key;
+}
+
+template <class T>
+std::optional<T> Set<T>::try_max() const noexcept(std::is_nothrow_copy_constructible_v<T>)
+{
+    if (max_node == nullptr)
+        return std::nullopt;
+
+    return max_node->key;
+}
+
+template <class T>
+Node<T> *Set<T>::remove_min(NodePtr p)
+{
+    p = unshare(p);
+    visit_node(false);
+
+    if (p->left == nullptr)
+    {
+        NodePtr child = p->right;
+
+        if (p == max_node)
+            max_node = nullptr;
+
+        delete p;
+        count(StatsCounter::Frees);
+        size_m--;
+        return child;
+    }
+
+    p->left = remove_min(p->left);
+
+    return fixup_deletion(p);
+}
+
+template <class T>
+Node<T> *Set<T>::remove_max(NodePtr p)
+{
+    p = unshare(p);
+    visit_node(false);
+
+    if (p->right == nullptr)
+    {
+        NodePtr child = p->left;
+
+        if (p == min_node)
+            min_node = nullptr;
+
+        delete p;
+        count(StatsCounter::Frees);
+        size_m--;
+        return child;
+    }
+
+    p->right = remove_max(p->right);
+
+    return fixup_deletion(p);
+}
+
+template <class T>
+T Set<T>::pop_min()
+{
+    if (root == nullptr)
+        throw std::runtime_error("Nao ha elementos no Set");
+
+    T key = min_node->key;
 
-    return aux->key;
+    begin_descent();
+    min_node = nullptr;
+    root = remove_min(root);
+
+    refresh_extremes();
+    note_filter_erase();
+
+    return key;
+}
+
+template <class T>
+T Set<T>::pop_max()
+{
+    if (root == nullptr)
+        throw std::runtime_error("Nao ha elementos no Set");
+
+    T key = max_node->key;
+
+    begin_descent();
+    max_node = nullptr;
+    root = remove_max(root);
+
+    refresh_extremes();
+    note_filter_erase();
+
+    return key;
 }
 
 template <class T>
@@ -745,11 +1539,14 @@ T Set<T>::successor(const T &key) const
     if (root == nullptr)
         throw std::runtime_error("Nao ha elementos no Set");
 
+    begin_descent();
     NodePtr aux{root};
     NodePtr succ{nullptr};
 
     while (aux != nullptr)
     {
+        visit_node();
+
         if (key < aux->key)
         {
             succ = aux;
@@ -768,7 +1565,10 @@ T Set<T>::successor(const T &key) const
     {
         aux = aux->right;
         while (aux->left != nullptr)
+        {
+            visit_node(false);
             aux = aux->left;
+        }
 
         return aux->key;
     }
@@ -785,11 +1585,14 @@ T Set<T>::predecessor(const T &key) const
     if (root == nullptr)
         throw std::runtime_error("Nao ha elementos no Set");
 
+    begin_descent();
     NodePtr aux{root};
     NodePtr succ{nullptr};
 
     while (aux != nullptr)
     {
+        visit_node();
+
         if (key < aux->key)
             aux = aux->left;
 
@@ -809,7 +1612,10 @@ T Set<T>::predecessor(const T &key) const
     {
         aux = aux->left;
         while (aux->right != nullptr)
+        {
+            visit_node(false);
             aux = aux->right;
+        }
 
         return aux->key;
     }
@@ -820,6 +1626,199 @@ T Set<T>::predecessor(const T &key) const
     return succ->key;
 }
 
+template <class T>
+std::optional<T> Set<T>::find_next(const T &key) const noexcept(std::is_nothrow_copy_constructible_v<T>)
+{
+    begin_descent();
+    NodePtr aux{root};
+    NodePtr next{nullptr};
+
+    while (aux != nullptr)
+    {
+        visit_node();
+
+        if (key < aux->key)
+        {
+            next = aux;
+            aux = aux->left;
+        }
+        else
+            aux = aux->right;
+    }
+
+    if (next == nullptr)
+        return std::nullopt;
+
+    return next->key;
+}
+
+template <class T>
+std::optional<T> Set<T>::find_prev(const T &key) const noexcept(std::is_nothrow_copy_constructible_v<T>)
+{
+    begin_descent();
+    NodePtr aux{root};
+    NodePtr prev{nullptr};
+
+    while (aux != nullptr)
+    {
+        visit_node();
+
+        if (aux->key < key)
+        {
+            prev = aux;
+            aux = aux->right;
+        }
+        else
+            aux = aux->left;
+    }
+
+    if (prev == nullptr)
+        return std::nullopt;
+
+    return prev->key;
+}
+
+template <class T>
+template <typename F>
+void Set<T>::for_each(F f) const
+{
+    for_each_inorder(f);
+}
+
+template <class T>
+template <typename F>
+bool Set<T>::visit(F &f, const T &key)
+{
+    if constexpr (std::is_same_v<std::invoke_result_t<F &, const T &>, bool>)
+        return std::invoke(f, key);
+    else
+    {
+        std::invoke(f, key);
+        return true;
+    }
+}
+
+template <class T>
+template <typename F>
+bool Set<T>::for_each_inorder(F &&f) const
+{
+    std::array<NodePtr, MAX_HEIGHT> nodes;
+    size_t top{0};
+    NodePtr aux{root};
+
+    while (aux != nullptr or top > 0)
+    {
+        while (aux != nullptr)
+        {
+            nodes[top++] = aux;
+            aux = aux->left;
+        }
+
+        aux = nodes[--top];
+        if (!visit(f, aux->key))
+            return false;
+
+        aux = aux->right;
+    }
+
+    return true;
+}
+
+template <class T>
+template <typename F>
+bool Set<T>::for_each_preorder(F &&f) const
+{
+    std::array<NodePtr, MAX_HEIGHT> nodes;
+    size_t top{0};
+    NodePtr aux{root};
+
+    while (aux != nullptr or top > 0)
+    {
+        while (aux != nullptr)
+        {
+            if (!visit(f, aux->key))
+                return false;
+
+            nodes[top++] = aux;
+            aux = aux->left;
+        }
+
+        aux = nodes[--top]->right;
+    }
+
+    return true;
+}
+
+template <class T>
+template <typename F>
+bool Set<T>::for_each_postorder(F &&f) const
+{
+    std::array<NodePtr, MAX_HEIGHT> nodes;
+    size_t top{0};
+    NodePtr aux{root};
+    NodePtr last{nullptr};
+
+    while (aux != nullptr or top > 0)
+    {
+        while (aux != nullptr)
+        {
+            nodes[top++] = aux;
+            aux = aux->left;
+        }
+
+        NodePtr peek = nodes[top - 1];
+        if (peek->right != nullptr and peek->right != last)
+            aux = peek->right;
+        else
+        {
+            if (!visit(f, peek->key))
+                return false;
+
+            last = peek;
+            top--;
+        }
+    }
+
+    return true;
+}
+
+template <class T>
+template <typename F>
+bool Set<T>::for_each_levelorder(F &&f) const
+{
+    if (root == nullptr)
+        return true;
+
+    // Cada nível deixa no máximo um irmão direito pendente por profundidade
+    std::array<std::pair<NodePtr, int>, MAX_HEIGHT + 1> nodes;
+
+    for (int level = 0; level < root->height; level++)
+    {
+        size_t top{0};
+        nodes[top++] = {root, 0};
+
+        while (top > 0)
+        {
+            auto [aux, depth] = nodes[--top];
+
+            if (depth == level)
+            {
+                if (!visit(f, aux->key))
+                    return false;
+                continue;
+            }
+
+            if (aux->right != nullptr and depth + aux->right->height >= level)
+                nodes[top++] = {aux->right, depth + 1};
+
+            if (aux->left != nullptr and depth + aux->left->height >= level)
+                nodes[top++] = {aux->left, depth + 1};
+        }
+    }
+
+    return true;
+}
+
 template <class T>
 void Set<T>::insertUnion(Set<T> &result, const NodePtr &node) const
 {
@@ -932,86 +1931,274 @@ Set<T> Set<T>::operator-(const Set &other) const
 }
 
 template <class T>
-void Set<T>::printInOrder()
+Generator<T> Set<T>::inorder() const
 {
-    printInOrder(root);
-}
-
-template <class T>
-void Set<T>::printInOrder(NodePtr node)
-{
-    if (node == nullptr)
-        return;
+    std::array<NodePtr, MAX_HEIGHT> nodes;
+    size_t top{0};
+    NodePtr aux{root};
 
-    else
+    while (aux != nullptr or top > 0)
     {
-        printInOrder(node->left);
-        std::cout << node->key << " ";
-        printInOrder(node->right);
+        while (aux != nullptr)
+        {
+            nodes[top++] = aux;
+            aux = aux->left;
+        }
+
+        aux = nodes[--top];
+        co_yield aux->key;
+
+        aux = aux->right;
     }
 }
 
 template <class T>
-void Set<T>::printPreOrder()
+Generator<T> Set<T>::levelorder() const
 {
-    printPreOrder(root);
-}
+    if (root == nullptr)
+        co_return;
+
+    std::array<std::pair<NodePtr, int>, MAX_HEIGHT + 1> nodes;
+
+    for (int level = 0; level < root->height; level++)
+    {
+        size_t top{0};
+        nodes[top++] = {root, 0};
+
+        while (top > 0)
+        {
+            auto [aux, depth] = nodes[--top];
+
+            if (depth == level)
+            {
+                co_yield aux->key;
+                continue;
+            }
+
+            if (aux->right != nullptr and depth + aux->right->height >= level)
+                nodes[top++] = {aux->right, depth + 1};
+
+            if (aux->left != nullptr and depth + aux->left->height >= level)
+                nodes[top++] = {aux->left, depth + 1};
+        }
+    }
+}
 
 template <class T>
-void Set<T>::printPreOrder(NodePtr node)
+Generator<T> Set<T>::range(T low, T high) const
 {
-    if (node == nullptr)
-        return;
+    std::array<NodePtr, MAX_HEIGHT> nodes;
+    size_t top{0};
+    NodePtr aux{root};
 
-    else
+    // Empilha apenas os ancestrais com chave >= low; os demais ficam fora do intervalo
+    while (aux != nullptr)
     {
-        std::cout << node->key << " ";
-        printPreOrder(node->left);
-        printPreOrder(node->right);
+        if (aux->key < low)
+            aux = aux->right;
+        else
+        {
+            nodes[top++] = aux;
+            aux = aux->left;
+        }
+    }
+
+    while (top > 0)
+    {
+        aux = nodes[--top];
+        if (high < aux->key)
+            co_return;
+
+        co_yield aux->key;
+
+        for (aux = aux->right; aux != nullptr; aux = aux->left)
+            nodes[top++] = aux;
     }
 }
 
 template <class T>
-void Set<T>::printPostOrder()
+template <class Sink>
+auto Set<T>::key_printer(BufferedWriter<Sink> &writer)
 {
-    printPostOrder(root);
+    return [&writer](const T &key)
+    {
+        writer.write_key(key);
+        writer.write(' ');
+    };
 }
 
 template <class T>
-void Set<T>::printPostOrder(NodePtr node)
+void Set<T>::printInOrder() const
 {
-    if (node == nullptr)
+    printInOrder(std::cout);
+}
+
+template <class T>
+void Set<T>::printInOrder(std::ostream &out) const
+{
+    BufferedWriter<std::ostream *> writer(&out);
+    for_each_inorder(key_printer(writer));
+}
+
+template <class T>
+template <std::output_iterator<char> OutputIt>
+OutputIt Set<T>::printInOrder(OutputIt out) const
+{
+    BufferedWriter<OutputIt> writer(out);
+    for_each_inorder(key_printer(writer));
+    return writer.flush();
+}
+
+template <class T>
+void Set<T>::printPreOrder() const
+{
+    printPreOrder(std::cout);
+}
+
+template <class T>
+void Set<T>::printPreOrder(std::ostream &out) const
+{
+    BufferedWriter<std::ostream *> writer(&out);
+    for_each_preorder(key_printer(writer));
+}
+
+template <class T>
+template <std::output_iterator<char> OutputIt>
+OutputIt Set<T>::printPreOrder(OutputIt out) const
+{
+    BufferedWriter<OutputIt> writer(out);
+    for_each_preorder(key_printer(writer));
+    return writer.flush();
+}
+
+template <class T>
+void Set<T>::printPostOrder() const
+{
+    printPostOrder(std::cout);
+}
+
+template <class T>
+void Set<T>::printPostOrder(std::ostream &out) const
+{
+    BufferedWriter<std::ostream *> writer(&out);
+    for_each_postorder(key_printer(writer));
+}
+
+template <class T>
+template <std::output_iterator<char> OutputIt>
+OutputIt Set<T>::printPostOrder(OutputIt out) const
+{
+    BufferedWriter<OutputIt> writer(out);
+    for_each_postorder(key_printer(writer));
+    return writer.flush();
+}
+
+template <class T>
+void Set<T>::printLarge() const
+{
+    printLarge(std::cout);
+}
+
+template <class T>
+void Set<T>::printLarge(std::ostream &out) const
+{
+    BufferedWriter<std::ostream *> writer(&out);
+    for_each_levelorder(key_printer(writer));
+}
+
+template <class T>
+template <std::output_iterator<char> OutputIt>
+OutputIt Set<T>::printLarge(OutputIt out) const
+{
+    BufferedWriter<OutputIt> writer(out);
+    for_each_levelorder(key_printer(writer));
+    return writer.flush();
+}
+
+template <class T>
+void Set<T>::bshow() const
+{
+    bshow(std::cout);
+}
+
+template <class T>
+void Set<T>::bshow(std::ostream &out, size_t max_depth, size_t max_nodes) const
+{
+    BufferedWriter<std::ostream *> writer(&out);
+    BshowState state{writer, std::string(), max_depth, max_nodes};
+    state.prefix.reserve(8 * (root != nullptr ? root->height : 1));
+
+    bshow(root, 0, '\0', state);
+
+    if (state.shown > max_nodes)
+        writer.write("...\n");
+}
+
+template <class T>
+void Set<T>::bshow(NodePtr node, size_t depth, char direction, BshowState &state) const
+{
+    if (state.shown > state.max_nodes)
         return;
 
-    else
+    bool has_children = node != nullptr and (node->left != nullptr or node->right != nullptr);
+    bool expand = has_children and depth < state.max_depth;
+
+    // O trecho de indentação de um filho depende de ele mudar de lado em relação ao pai
+    auto child = [&](NodePtr next, char side)
     {
-        printPostOrder(node->left);
-        printPostOrder(node->right);
-        std::cout << node->key << " ";
+        size_t length = state.prefix.size();
+        if (depth > 0)
+            state.prefix += (direction != side ? "│   " : "    ");
+
+        bshow(next, depth + 1, side, state);
+        state.prefix.resize(length);
+    };
+
+    if (expand)
+        child(node->right, 'r');
+
+    if (node != nullptr and ++state.shown > state.max_nodes)
+        return;
+
+    state.writer.write(state.prefix);
+    if (direction != '\0')
+        state.writer.write(direction == 'r' ? "┌───" : "└───");
+
+    if (node == nullptr)
+    {
+        state.writer.write("#\n");
+        return;
     }
+
+    state.writer.write_key(node->key);
+    state.writer.write(has_children and !expand ? " ...\n" : "\n");
+
+    if (expand)
+        child(node->left, 'l');
 }
 
 template <class T>
-void Set<T>::printLarge()
+void Set<T>::rebuild_filter()
 {
-    printLarge(root);
+    filter_m->reset(2 * size_m);
+    fill_filter();
 }
 
 template <class T>
-void Set<T>::printLarge(NodePtr node)
+void Set<T>::fill_filter()
 {
-    if (!node)
+    if (root == nullptr)
         return;
 
-    std::queue<NodePtr> nodes;
-    nodes.push(node);
+    std::stack<NodePtr> nodes;
+    nodes.push(root);
 
     while (!nodes.empty())
     {
-        NodePtr atual = nodes.front();
+        NodePtr atual = nodes.top();
         nodes.pop();
 
-        std::cout << atual->key << " ";
+        filter_m->add(atual->key);
 
         if (atual->left != nullptr)
             nodes.push(atual->left);
@@ -1022,31 +2209,420 @@ void Set<T>::printLarge(NodePtr node)
 }
 
 template <class T>
-void Set<T>::bshow()
+void Set<T>::enable_filter(double bits_per_key)
 {
-    bshow(root, "");
+    filter_m = std::make_unique<BloomFilter<T>>(2 * size_m, bits_per_key);
+    fill_filter();
 }
 
 template <class T>
-void Set<T>::bshow(NodePtr node, std::string heranca)
+void Set<T>::disable_filter() noexcept
 {
-    if (node != nullptr and (node->left != nullptr or node->right != nullptr))
-        bshow(node->right, heranca + "r");
-
-    for (int i = 0; i < (int)heranca.size() - 1; i++)
-        std::cout << (heranca[i] != heranca[i + 1] ? "│   " : "    ");
+    filter_m.reset();
+}
 
-    if (heranca != "")
-        std::cout << (heranca.back() == 'r' ? "┌───" : "└───");
+template <class T>
+bool Set<T>::has_filter() const noexcept
+{
+    return filter_m != nullptr;
+}
 
+template <class T>
+void Set<T>::free_built(NodePtr node) noexcept
+{
     if (node == nullptr)
-    {
-        std::cout << "#" << std::endl;
         return;
+
+    free_built(node->left);
+    free_built(node->right);
+    delete node;
+}
+
+template <class T>
+Node<T> *Set<T>::build_sorted(const T *keys, size_t n, unsigned threads)
+{
+    if (n == 0)
+        return nullptr;
+
+    size_t middle = n / 2;
+    NodePtr node = new Node<T>(keys[middle]);
+
+    try
+    {
+        if (threads > 1 and n >= PARALLEL_GRAIN)
+        {
+            unsigned left_threads = threads / 2;
+            std::exception_ptr error;
+
+            {
+                // O destrutor de std::jthread faz o join, mesmo se a subárvore direita lançar
+                std::jthread worker([&node, &error, keys, middle, left_threads]()
+                                    {
+                                        try
+                                        {
+                                            node->left = build_sorted(keys, middle, left_threads);
+                                        }
+                                        catch (...)
+                                        {
+                                            error = std::current_exception();
+                                        } });
+
+                node->right = build_sorted(keys + middle + 1, n - middle - 1, threads - left_threads);
+            }
+
+            if (error)
+                std::rethrow_exception(error);
+        }
+        else
+        {
+            node->left = build_sorted(keys, middle, 1);
+            node->right = build_sorted(keys + middle + 1, n - middle - 1, 1);
+        }
+    }
+    catch (...)
+    {
+        free_built(node);
+        throw;
     }
 
-    std::cout << node->key << std::endl;
+    int left_height = (node->left != nullptr) ? node->left->height : 0;
+    int right_height = (node->right != nullptr) ? node->right->height : 0;
+    node->height = 1 + std::max(left_height, right_height);
 
-    if (node != nullptr and (node->left != nullptr or node->right != nullptr))
-        bshow(node->left, heranca + "l");
-}
\ No newline at end of file
+    return node;
+}
+
+template <class T>
+void Set<T>::parallel_sort(std::vector<T> &keys, unsigned threads)
+{
+    size_t chunks = std::min<size_t>(threads, std::max<size_t>(1, keys.size() / PARALLEL_GRAIN));
+
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t i = 0; i <= chunks; i++)
+        bounds[i] = keys.size() * i / chunks;
+
+    auto begin = keys.begin();
+    std::vector<std::exception_ptr> errors(chunks);
+
+    // Executa `task` em uma thread por item; as threads terminam (join) antes do retorno,
+    // mesmo se a criação de uma delas ou a tarefa da thread atual lançar
+    auto run = [&errors](std::vector<std::function<void()>> &tasks)
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(tasks.size());
+
+        for (size_t i = 1; i < tasks.size(); i++)
+            workers.emplace_back([&errors, &tasks, i]()
+                                 {
+                                     try
+                                     {
+                                         tasks[i]();
+                                     }
+                                     catch (...)
+                                     {
+                                         errors[i] = std::current_exception();
+                                     } });
+
+        if (!tasks.empty())
+            tasks[0]();
+
+        workers.clear();
+
+        for (std::exception_ptr &error : errors)
+            if (error)
+                std::rethrow_exception(error);
+    };
+
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < chunks; i++)
+        tasks.push_back([begin, &bounds, i]()
+                        { std::sort(begin + bounds[i], begin + bounds[i + 1]); });
+    run(tasks);
+
+    for (size_t width = 1; width < chunks; width *= 2)
+    {
+        tasks.clear();
+
+        for (size_t i = 0; i + width < chunks; i += 2 * width)
+        {
+            auto first = begin + bounds[i];
+            auto middle = begin + bounds[i + width];
+            auto last = begin + bounds[std::min(i + 2 * width, chunks)];
+
+            tasks.push_back([first, middle, last]()
+                            { std::inplace_merge(first, middle, last); });
+        }
+
+        run(tasks);
+    }
+}
+
+template <class T>
+void Set<T>::assign_sorted(const std::vector<T> &keys, unsigned threads)
+{
+    // Monta a nova árvore antes de liberar a atual: se a construção lançar, nada muda
+    NodePtr built = build_sorted(keys.data(), keys.size(), threads);
+
+    clear();
+
+    root = built;
+    size_m = keys.size();
+    count(StatsCounter::Allocations, keys.size());
+    refresh_extremes();
+
+    if (filter_m)
+        rebuild_filter();
+}
+
+template <class T>
+Set<T> Set<T>::from_sorted(const std::vector<T> &keys, unsigned threads)
+{
+    for (size_t i = 1; i < keys.size(); i++)
+        if (!(keys[i - 1] < keys[i]))
+            throw std::invalid_argument("Chaves fora de ordem ou repetidas");
+
+    Set<T> result;
+    result.assign_sorted(keys, threads == 0 ? 1 : threads);
+
+    return result;
+}
+
+template <class T>
+template <typename Range>
+Set<T> Set<T>::build_parallel(const Range &range, unsigned threads)
+{
+    if (threads == 0)
+        threads = 1;
+
+    std::vector<T> keys(std::begin(range), std::end(range));
+
+    parallel_sort(keys, threads);
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    Set<T> result;
+    result.assign_sorted(keys, threads);
+
+    return result;
+}
+
+template <class T>
+void Set<T>::save(std::ostream &out) const
+{
+    // O checksum fica no cabeçalho, então as chaves são codificadas duas vezes:
+    // a primeira passada apenas calcula o checksum.
+    BinaryWriter hasher;
+    for_each([&hasher](const T &key)
+             { KeyCodec<T>::encode(hasher, key); });
+
+    SetFileHeader header{};
+    std::memcpy(header.magic, SetFileHeader::MAGIC, sizeof(header.magic));
+    header.type_tag = KeyCodec<T>::TYPE_TAG;
+    header.count = size_m;
+    header.checksum = hasher.checksum();
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    BinaryWriter writer(&out);
+    for_each([&writer](const T &key)
+             { KeyCodec<T>::encode(writer, key); });
+    writer.flush();
+
+    if (!out)
+        throw std::runtime_error("Falha ao gravar o Set");
+}
+
+template <class T>
+void Set<T>::save(const std::string &path) const
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("Nao foi possivel abrir o arquivo: " + path);
+
+    save(out);
+}
+
+template <class T>
+void Set<T>::load(std::istream &in)
+{
+    SetFileHeader header;
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        throw std::runtime_error("Arquivo de Set truncado");
+
+    if (std::memcmp(header.magic, SetFileHeader::MAGIC, sizeof(header.magic)) != 0)
+        throw std::runtime_error("Arquivo nao contem um Set");
+
+    if (header.type_tag != KeyCodec<T>::TYPE_TAG)
+        throw std::runtime_error("Tipo das chaves do arquivo nao corresponde ao Set");
+
+    BinaryReader reader(in);
+    std::vector<T> keys;
+    keys.reserve(static_cast<size_t>(std::min<uint64_t>(header.count, 1 << 20)));
+
+    for (uint64_t i = 0; i < header.count; i++)
+    {
+        keys.push_back(KeyCodec<T>::decode(reader));
+
+        if (i > 0 and !(keys[i - 1] < keys[i]))
+            throw std::runtime_error("Arquivo de Set corrompido: chaves fora de ordem");
+    }
+
+    if (reader.checksum() != header.checksum)
+        throw std::runtime_error("Arquivo de Set corrompido: checksum invalido");
+
+    assign_sorted(keys, std::thread::hardware_concurrency());
+}
+
+template <class T>
+void Set<T>::load(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("Nao foi possivel abrir o arquivo: " + path);
+
+    load(in);
+}
+
+template <class T>
+BloomFilterStats Set<T>::filter_stats() const
+{
+    if (!filter_m)
+        throw std::runtime_error("Filtro nao habilitado");
+
+    return filter_m->stats();
+}
+template <class T>
+StatsCounters<> &Set<T>::thread_counters() noexcept
+{
+    thread_local StatsCounters<> counters;
+    return counters;
+}
+
+template <class T>
+uint64_t &Set<T>::descent_depth() noexcept
+{
+    thread_local uint64_t depth{0};
+    return depth;
+}
+
+template <class T>
+void Set<T>::count(StatsCounter counter, uint64_t n) const noexcept
+{
+    if constexpr (SET_STATS_ENABLED)
+    {
+        stats_m.add(counter, n);
+        thread_counters().add(counter, n);
+    }
+}
+
+template <class T>
+void Set<T>::begin_descent() const noexcept
+{
+    if constexpr (SET_STATS_ENABLED)
+        descent_depth() = 0;
+}
+
+template <class T>
+void Set<T>::visit_node(bool compared) const noexcept
+{
+    if constexpr (SET_STATS_ENABLED)
+    {
+        if (compared)
+            count(StatsCounter::Comparisons);
+
+        uint64_t depth = ++descent_depth();
+        stats_m.raise(StatsCounter::MaxDepth, depth);
+        thread_counters().raise(StatsCounter::MaxDepth, depth);
+    }
+}
+
+template <class T>
+SetStats Set<T>::stats() const noexcept
+{
+    return stats_m.snapshot();
+}
+
+template <class T>
+void Set<T>::reset_stats() noexcept
+{
+    stats_m.reset();
+}
+
+template <class T>
+SetStats Set<T>::thread_stats() noexcept
+{
+    return thread_counters().snapshot();
+}
+
+template <class T>
+void Set<T>::reset_thread_stats() noexcept
+{
+    thread_counters().reset();
+}
+
+template <class T>
+size_t Set<T>::key_heap_bytes(const T &key) noexcept
+{
+    if constexpr (requires { key.capacity(); key.data(); typename T::value_type; })
+    {
+        // Buffer dentro do próprio objeto (otimização de strings curtas): nada no heap
+        const char *data = reinterpret_cast<const char *>(key.data());
+        const char *object = reinterpret_cast<const char *>(&key);
+        if (data >= object and data < object + sizeof(T))
+            return 0;
+
+        size_t terminator = std::is_same_v<T, std::basic_string<typename T::value_type>> ? 1 : 0;
+        return allocation_size((key.capacity() + terminator) * sizeof(typename T::value_type));
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+template <class T>
+void Set<T>::shape_stats(NodePtr node, size_t depth, ShapeStats &stats, size_t &path_sum) const
+{
+    if (node == nullptr)
+        return;
+
+    stats.nodes++;
+    path_sum += depth + 1;
+
+    if (stats.depth_histogram.size() <= depth)
+        stats.depth_histogram.resize(depth + 1);
+    stats.depth_histogram[depth]++;
+
+    int factor = (node->right ? node->right->height : 0) - (node->left ? node->left->height : 0);
+    if (factor >= -1 and factor <= 1)
+        stats.balance_factors[static_cast<size_t>(factor + 1)]++;
+    else
+        stats.unbalanced++;
+
+    if (shared(node))
+        stats.shared_nodes++;
+
+    stats.key_bytes += key_heap_bytes(node->key);
+
+    shape_stats(node->left, depth + 1, stats, path_sum);
+    shape_stats(node->right, depth + 1, stats, path_sum);
+}
+
+template <class T>
+ShapeStats Set<T>::shape_stats() const
+{
+    ShapeStats stats;
+    size_t path_sum = 0;
+
+    shape_stats(root, 0, stats, path_sum);
+
+    stats.height = stats.depth_histogram.size();
+    if (stats.nodes > 0)
+        stats.average_path_length = static_cast<double>(path_sum) / static_cast<double>(stats.nodes);
+
+    stats.node_bytes = stats.nodes * allocation_size(sizeof(Node<T>));
+    if (filter_m)
+        stats.filter_bytes = filter_m->stats().bits / 8;
+    stats.heap_bytes = stats.node_bytes + stats.key_bytes + stats.filter_bytes;
+
+    return stats;
+}
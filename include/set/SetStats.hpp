@@ -0,0 +1,172 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Contadores de instrumentação de um `Set`, para entender o custo das operações.
+ *
+ * - `comparisons`: comparações de chaves feitas ao descer a árvore.
+ * - `left_rotations`, `right_rotations`: chamadas a `leftRotation` e `rightRotation`.
+ * - `single_rotations`, `double_rotations`: rebalanceamentos com uma ou duas rotações.
+ * - `allocations`, `frees`: nós alocados (inclusive cópias do copy-on-write) e liberados.
+ * - `max_depth`: maior número de nós visitados em uma única descida.
+ *
+ * Só são contados quando o código é compilado com `-DSET_STATS`; sem a macro todos os
+ * campos ficam zerados e a instrumentação não gera código.
+ */
+struct SetStats
+{
+    uint64_t comparisons{0};
+    uint64_t left_rotations{0};
+    uint64_t right_rotations{0};
+    uint64_t single_rotations{0};
+    uint64_t double_rotations{0};
+    uint64_t allocations{0};
+    uint64_t frees{0};
+    uint64_t max_depth{0};
+};
+
+/**
+ * @brief Forma e uso de memória de um `Set`, calculados por `Set::shape_stats()`.
+ *
+ * - `height`: altura da árvore (0 se vazia, 1 com apenas a raiz).
+ * - `nodes`: número de nós.
+ * - `depth_histogram`: `depth_histogram[d]` é o número de nós na profundidade `d` (raiz em 0).
+ * - `average_path_length`: média de nós visitados por uma busca bem-sucedida.
+ * - `balance_factors`: nós com fator de balanceamento -1, 0 e +1 (altura da direita menos a da esquerda).
+ * - `unbalanced`: nós com fator fora de [-1, 1], que indicariam uma árvore AVL corrompida.
+ * - `shared_nodes`: nós compartilhados com cópias do conjunto (copy-on-write).
+ * - `node_bytes`: memória estimada dos nós, incluindo o custo do alocador por bloco.
+ * - `key_bytes`: memória alocada pelas próprias chaves (conteúdo de strings, vetores, ...).
+ * - `filter_bytes`: memória do filtro de Bloom, se habilitado.
+ * - `heap_bytes`: soma das três estimativas anteriores.
+ *
+ * Nós compartilhados entram na estimativa de cada cópia que os referencia.
+ */
+struct ShapeStats
+{
+    size_t height{0};
+    size_t nodes{0};
+    std::vector<size_t> depth_histogram;
+    double average_path_length{0.0};
+    std::array<size_t, 3> balance_factors{};
+    size_t unbalanced{0};
+    size_t shared_nodes{0};
+    size_t node_bytes{0};
+    size_t key_bytes{0};
+    size_t filter_bytes{0};
+    size_t heap_bytes{0};
+};
+
+/**
+ * @brief Tamanho estimado do bloco que o alocador reserva para `bytes` bytes.
+ *
+ * Segue o malloc da glibc em 64 bits: 8 bytes de cabeçalho, arredondamento para
+ * múltiplos de 16 e bloco mínimo de 32 bytes. Outros alocadores têm custos parecidos.
+ */
+constexpr size_t allocation_size(size_t bytes) noexcept
+{
+    if (bytes == 0)
+        return 0;
+
+    size_t chunk = (bytes + sizeof(size_t) + 15) & ~size_t(15);
+    return chunk < 32 ? 32 : chunk;
+}
+
+#if defined(SET_STATS)
+inline constexpr bool SET_STATS_ENABLED = true;
+#else
+inline constexpr bool SET_STATS_ENABLED = false;
+#endif
+
+/**
+ * @brief Índice de cada contador de `SetStats` em `StatsCounters`.
+ */
+enum class StatsCounter
+{
+    Comparisons,
+    LeftRotations,
+    RightRotations,
+    SingleRotations,
+    DoubleRotations,
+    Allocations,
+    Frees,
+    MaxDepth,
+    Count,
+};
+
+/**
+ * @brief Acumulador de `SetStats`.
+ *
+ * Os contadores são atômicos, mas incrementados com leitura e escrita relaxadas em vez
+ * de uma operação atômica de leitura-modificação-escrita: o custo é o de um incremento
+ * comum e leitores concorrentes do mesmo conjunto (sob o lock compartilhado de
+ * `ConcurrentSet`, por exemplo) não geram condição de corrida, mas podem perder contagens.
+ *
+ * A especialização para `Enabled == false` é vazia e todas as operações são nulas.
+ */
+template <bool Enabled = SET_STATS_ENABLED>
+class StatsCounters
+{
+private:
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(StatsCounter::Count)> values{};
+
+    std::atomic<uint64_t> &at(StatsCounter counter) noexcept
+    {
+        return values[static_cast<size_t>(counter)];
+    }
+
+    uint64_t get(StatsCounter counter) const noexcept
+    {
+        return values[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+    }
+
+public:
+    void add(StatsCounter counter, uint64_t n = 1) noexcept
+    {
+        std::atomic<uint64_t> &value = at(counter);
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Guarda `candidate` no contador se for maior que o valor atual.
+     */
+    void raise(StatsCounter counter, uint64_t candidate) noexcept
+    {
+        std::atomic<uint64_t> &value = at(counter);
+        if (candidate > value.load(std::memory_order_relaxed))
+            value.store(candidate, std::memory_order_relaxed);
+    }
+
+    SetStats snapshot() const noexcept
+    {
+        return {get(StatsCounter::Comparisons), get(StatsCounter::LeftRotations), get(StatsCounter::RightRotations),
+                get(StatsCounter::SingleRotations), get(StatsCounter::DoubleRotations), get(StatsCounter::Allocations),
+                get(StatsCounter::Frees), get(StatsCounter::MaxDepth)};
+    }
+
+    void reset() noexcept
+    {
+        for (std::atomic<uint64_t> &value : values)
+            value.store(0, std::memory_order_relaxed);
+    }
+};
+
+template <>
+class StatsCounters<false>
+{
+public:
+    void add(StatsCounter, uint64_t = 1) noexcept {}
+    void raise(StatsCounter, uint64_t) noexcept {}
+
+    SetStats snapshot() const noexcept
+    {
+        return {};
+    }
+
+    void reset() noexcept {}
+};
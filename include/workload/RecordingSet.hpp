@@ -0,0 +1,132 @@
+#pragma once
+
+#include "set/Set.hpp"
+#include "workload/Trace.hpp"
+
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+
+/**
+ * @brief Invólucro de `Set` que grava cada operação em um trace (`workload/Trace.hpp`).
+ *
+ * Repassa as operações ao conjunto e registra tipo e argumento antes de executá-las,
+ * então uma operação que lança exceção (`successor` sem sucessor, por exemplo) também
+ * aparece no trace. O trace pode ser reexecutado depois com `bin/tools/Replay`.
+ *
+ * O conjunto e o fluxo são referenciados, não copiados, e devem viver mais que o
+ * invólucro. As chaves são gravadas como `int64_t`, por isso `T` é limitado a inteiros
+ * de até 64 bits; chaves sem sinal acima de `INT64_MAX` mudam de ordem na reexecução.
+ *
+ * @tparam T Tipo inteiro dos elementos.
+ */
+template <std::integral T>
+    requires(sizeof(T) <= sizeof(int64_t))
+class RecordingSet
+{
+private:
+    Set<T> &set;
+    workload::TraceWriter writer;
+
+    void record(workload::OpType type, const T &key)
+    {
+        writer.append({type, static_cast<int64_t>(key)});
+    }
+
+public:
+    /**
+     * @brief Passa a gravar as operações sobre `set` em `out`, a começar pelo cabeçalho.
+     */
+    RecordingSet(Set<T> &set, std::ostream &out) : set(set), writer(out) {}
+
+    RecordingSet(const RecordingSet &) = delete;
+    RecordingSet &operator=(const RecordingSet &) = delete;
+
+    void insert(const T &key)
+    {
+        record(workload::OpType::Insert, key);
+        set.insert(key);
+    }
+
+    void erase(const T &key)
+    {
+        record(workload::OpType::Erase, key);
+        set.erase(key);
+    }
+
+    bool contains(const T &key)
+    {
+        record(workload::OpType::Contains, key);
+        return set.contains(key);
+    }
+
+    T successor(const T &key)
+    {
+        record(workload::OpType::Successor, key);
+        return set.successor(key);
+    }
+
+    T predecessor(const T &key)
+    {
+        record(workload::OpType::Predecessor, key);
+        return set.predecessor(key);
+    }
+
+    /**
+     * @brief Gravada como `Successor`: na reexecução as duas formas são equivalentes.
+     */
+    std::optional<T> find_next(const T &key)
+    {
+        record(workload::OpType::Successor, key);
+        return set.find_next(key);
+    }
+
+    /**
+     * @brief Gravada como `Predecessor`.
+     */
+    std::optional<T> find_prev(const T &key)
+    {
+        record(workload::OpType::Predecessor, key);
+        return set.find_prev(key);
+    }
+
+    void clear()
+    {
+        writer.append({workload::OpType::Clear, 0});
+        set.clear();
+    }
+
+    size_t size() const
+    {
+        return set.size();
+    }
+
+    bool empty() const
+    {
+        return set.empty();
+    }
+
+    /**
+     * @brief Acesso somente leitura ao conjunto, para consultas que não são gravadas.
+     */
+    const Set<T> &view() const noexcept
+    {
+        return set;
+    }
+
+    /**
+     * @brief Grava no fluxo as operações ainda no buffer.
+     *
+     * @throw std::runtime_error Se a escrita falhar.
+     */
+    void flush()
+    {
+        writer.flush();
+    }
+
+    uint64_t recorded() const noexcept
+    {
+        return writer.count();
+    }
+};
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "workload/Workload.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Formato binário compacto de sequências de operações (traces).
+ *
+ * Cabeçalho de 16 bytes (`"AVLTRACE"`, versão e campo reservado, ambos de 32 bits
+ * little-endian) seguido de um registro por operação: 1 byte com o `OpType` e, exceto
+ * para `Clear`, a diferença entre a chave e a chave do registro anterior, em zigzag e
+ * LEB128. Chaves próximas da anterior (sequências, faixas, repetições) ocupam 1 ou 2
+ * bytes. O arquivo termina no último registro, então pode ser gravado em fluxo.
+ */
+namespace workload
+{
+    constexpr char TRACE_MAGIC[8] = {'A', 'V', 'L', 'T', 'R', 'A', 'C', 'E'};
+    constexpr uint32_t TRACE_VERSION = 1;
+
+    /**
+     * @brief Grava operações em um trace, com buffer próprio.
+     */
+    class TraceWriter
+    {
+    private:
+        static constexpr size_t BUFFER_SIZE = 1 << 16;
+
+        std::ostream &out;
+        std::vector<char> buffer;
+        int64_t previous{0};
+        uint64_t written{0};
+
+        void put(char byte)
+        {
+            buffer.push_back(byte);
+            if (buffer.size() >= BUFFER_SIZE)
+                flush();
+        }
+
+        void put_u32(uint32_t value)
+        {
+            for (int i = 0; i < 4; i++)
+                put(static_cast<char>(value >> (8 * i)));
+        }
+
+    public:
+        explicit TraceWriter(std::ostream &out) : out(out)
+        {
+            buffer.reserve(BUFFER_SIZE);
+            buffer.insert(buffer.end(), TRACE_MAGIC, TRACE_MAGIC + sizeof(TRACE_MAGIC));
+            put_u32(TRACE_VERSION);
+            put_u32(0);
+        }
+
+        TraceWriter(const TraceWriter &) = delete;
+        TraceWriter &operator=(const TraceWriter &) = delete;
+
+        ~TraceWriter()
+        {
+            // Sem exceções no destrutor: quem precisa saber do erro chama flush() antes
+            if (!buffer.empty())
+                out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        }
+
+        void append(const Operation &operation)
+        {
+            put(static_cast<char>(operation.type));
+            written++;
+
+            if (operation.type == OpType::Clear)
+                return;
+
+            // Diferença calculada em aritmética sem sinal para não estourar
+            int64_t delta = static_cast<int64_t>(static_cast<uint64_t>(operation.key) - static_cast<uint64_t>(previous));
+            uint64_t value = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+            previous = operation.key;
+
+            while (value >= 0x80)
+            {
+                put(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            put(static_cast<char>(value));
+        }
+
+        /**
+         * @throw std::runtime_error Se a escrita falhar.
+         */
+        void flush()
+        {
+            if (!buffer.empty())
+            {
+                out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                buffer.clear();
+            }
+
+            if (!out)
+                throw std::runtime_error("Falha ao gravar o trace");
+        }
+
+        uint64_t count() const noexcept
+        {
+            return written;
+        }
+    };
+
+    /**
+     * @brief Lê as operações de um trace, uma por vez.
+     */
+    class TraceReader
+    {
+    private:
+        std::istream &in;
+        int64_t previous{0};
+
+        bool get(char &byte)
+        {
+            return static_cast<bool>(in.get(byte));
+        }
+
+    public:
+        /**
+         * @throw std::runtime_error Se o cabeçalho for inválido.
+         */
+        explicit TraceReader(std::istream &in) : in(in)
+        {
+            char header[16];
+            if (!in.read(header, sizeof(header)) or std::memcmp(header, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0)
+                throw std::runtime_error("Arquivo nao contem um trace");
+
+            uint32_t version = 0;
+            for (int i = 0; i < 4; i++)
+                version |= static_cast<uint32_t>(static_cast<unsigned char>(header[8 + i])) << (8 * i);
+            if (version != TRACE_VERSION)
+                throw std::runtime_error("Versao de trace nao suportada");
+        }
+
+        /**
+         * @brief Lê a próxima operação. Retorna `false` no fim do trace.
+         *
+         * @throw std::runtime_error Se o trace terminar no meio de um registro ou for inválido.
+         */
+        bool next(Operation &operation)
+        {
+            char type;
+            if (!get(type))
+                return false;
+
+            if (type < static_cast<char>(OpType::Insert) or type > static_cast<char>(OpType::Clear))
+                throw std::runtime_error("Trace corrompido: operacao invalida");
+
+            operation.type = static_cast<OpType>(type);
+            operation.key = 0;
+            if (operation.type == OpType::Clear)
+                return true;
+
+            uint64_t value = 0;
+            for (unsigned shift = 0;; shift += 7)
+            {
+                char byte;
+                if (shift >= 64 or !get(byte))
+                    throw std::runtime_error("Trace truncado ou corrompido");
+
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                    break;
+            }
+
+            int64_t delta = static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+            previous = static_cast<int64_t>(static_cast<uint64_t>(previous) + static_cast<uint64_t>(delta));
+            operation.key = previous;
+
+            return true;
+        }
+    };
+
+    /**
+     * @brief Grava todas as operações no arquivo `path`.
+     */
+    inline void write_trace(const std::string &path, const std::vector<Operation> &operations)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("Nao foi possivel abrir o arquivo: " + path);
+
+        TraceWriter writer(out);
+        for (const Operation &operation : operations)
+            writer.append(operation);
+        writer.flush();
+    }
+
+    /**
+     * @brief Lê todas as operações do arquivo `path`.
+     */
+    inline std::vector<Operation> read_trace(const std::string &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("Nao foi possivel abrir o arquivo: " + path);
+
+        TraceReader reader(in);
+        std::vector<Operation> operations;
+        Operation operation;
+        while (reader.next(operation))
+            operations.push_back(operation);
+
+        return operations;
+    }
+}
@@ -0,0 +1,366 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Geradores de cargas de trabalho reproduzíveis para benchmarks e testes de estresse.
+ *
+ * Todos os geradores recebem uma semente e usam apenas `Rng` e algoritmos próprios
+ * (nada de `std::uniform_int_distribution` ou `std::shuffle`, cujos resultados variam
+ * entre bibliotecas padrão), então a mesma semente gera a mesma sequência em qualquer
+ * plataforma.
+ */
+namespace workload
+{
+    /**
+     * @brief Gerador SplitMix64: pequeno, rápido e com sequência definida pela semente.
+     */
+    class Rng
+    {
+    private:
+        uint64_t state;
+
+    public:
+        explicit Rng(uint64_t seed) noexcept : state(seed) {}
+
+        uint64_t next() noexcept
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        /**
+         * @brief Inteiro em `[0, bound)` (multiplicação de Lemire, viés desprezível).
+         */
+        uint64_t uniform(uint64_t bound) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            return static_cast<uint64_t>((static_cast<unsigned __int128>(next()) * bound) >> 64);
+#else
+            return next() % bound;
+#endif
+        }
+
+        /**
+         * @brief Real em `[0, 1)` com 53 bits de precisão.
+         */
+        double uniform_real() noexcept
+        {
+            return static_cast<double>(next() >> 11) * 0x1.0p-53;
+        }
+    };
+
+    /**
+     * @brief Embaralhamento de Fisher-Yates com `Rng`.
+     */
+    template <typename Value>
+    void shuffle(std::vector<Value> &values, Rng &rng)
+    {
+        for (size_t i = values.size(); i > 1; i--)
+            std::swap(values[i - 1], values[rng.uniform(i)]);
+    }
+
+    /**
+     * @brief Amostrador Zipf em `[1, n]` com P(k) proporcional a 1 / k^s.
+     *
+     * Usa rejeição-inversão (Hörmann e Derflinger), com custo O(1) por amostra e sem
+     * tabelas, mesmo para universos de centenas de milhões de chaves.
+     */
+    class Zipf
+    {
+    private:
+        double n;
+        double s;
+        double h_integral_x1;
+        double h_integral_n;
+        double threshold;
+
+        // log1p(x) / x, estável perto de 0
+        static double helper1(double x) noexcept
+        {
+            return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+        }
+
+        // expm1(x) / x, estável perto de 0
+        static double helper2(double x) noexcept
+        {
+            return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+        }
+
+        double h(double x) const noexcept
+        {
+            return std::exp(-s * std::log(x));
+        }
+
+        double h_integral(double x) const noexcept
+        {
+            double log_x = std::log(x);
+            return helper2((1.0 - s) * log_x) * log_x;
+        }
+
+        double h_integral_inverse(double x) const noexcept
+        {
+            double t = x * (1.0 - s);
+            if (t < -1.0)
+                t = -1.0;
+
+            return std::exp(helper1(t) * x);
+        }
+
+    public:
+        /**
+         * @throw std::invalid_argument Se `n == 0` ou `s <= 0`.
+         */
+        Zipf(uint64_t n, double s) : n(static_cast<double>(n)), s(s)
+        {
+            if (n == 0 or s <= 0.0)
+                throw std::invalid_argument("Zipf requer n > 0 e expoente positivo");
+
+            h_integral_x1 = h_integral(1.5) - 1.0;
+            h_integral_n = h_integral(this->n + 0.5);
+            threshold = 2.0 - h_integral_inverse(h_integral(2.5) - h(2.0));
+        }
+
+        uint64_t operator()(Rng &rng) const noexcept
+        {
+            for (;;)
+            {
+                double u = h_integral_n + rng.uniform_real() * (h_integral_x1 - h_integral_n);
+                double x = h_integral_inverse(u);
+                double k = std::floor(x + 0.5);
+
+                if (k < 1.0)
+                    k = 1.0;
+                else if (k > n)
+                    k = n;
+
+                if (k - x <= threshold or u >= h_integral(k + 0.5) - h(k))
+                    return static_cast<uint64_t>(k);
+            }
+        }
+    };
+
+    /**
+     * @brief Ordem das chaves de uma sequência de inserções.
+     */
+    enum class Pattern
+    {
+        Ascending,   // 0, 1, 2, ...: rotação a cada inserção
+        Descending,  // n - 1, n - 2, ...: rotação espelhada a cada inserção
+        Alternating, // 0, n - 1, 1, n - 2, ...: inserções sempre no meio, rotações duplas
+        Uniform,     // Aleatórias em todo o intervalo de int64 (repetições são raras)
+        Clustered,   // Faixas contíguas de `CLUSTER_SIZE` chaves em posições aleatórias
+    };
+
+    constexpr size_t CLUSTER_SIZE = 1024;
+
+    inline const char *to_string(Pattern pattern) noexcept
+    {
+        switch (pattern)
+        {
+        case Pattern::Ascending:
+            return "ascending";
+        case Pattern::Descending:
+            return "descending";
+        case Pattern::Alternating:
+            return "alternating";
+        case Pattern::Uniform:
+            return "uniform";
+        case Pattern::Clustered:
+            return "clustered";
+        }
+
+        return "";
+    }
+
+    /**
+     * @throw std::invalid_argument Se o nome não corresponder a nenhum padrão.
+     */
+    inline Pattern parse_pattern(const std::string &name)
+    {
+        for (Pattern pattern : {Pattern::Ascending, Pattern::Descending, Pattern::Alternating, Pattern::Uniform, Pattern::Clustered})
+            if (name == to_string(pattern))
+                return pattern;
+
+        throw std::invalid_argument("Padrao de chaves desconhecido: " + name);
+    }
+
+    /**
+     * @brief Gera `n` chaves na ordem do padrão. Os padrões determinísticos ignoram a semente.
+     */
+    inline std::vector<int64_t> keys(Pattern pattern, size_t n, uint64_t seed)
+    {
+        std::vector<int64_t> result(n);
+        Rng rng(seed);
+
+        switch (pattern)
+        {
+        case Pattern::Ascending:
+            for (size_t i = 0; i < n; i++)
+                result[i] = static_cast<int64_t>(i);
+            break;
+
+        case Pattern::Descending:
+            for (size_t i = 0; i < n; i++)
+                result[i] = static_cast<int64_t>(n - 1 - i);
+            break;
+
+        case Pattern::Alternating:
+            for (size_t i = 0; i < n; i++)
+                result[i] = static_cast<int64_t>(i % 2 == 0 ? i / 2 : n - 1 - i / 2);
+            break;
+
+        case Pattern::Uniform:
+            for (int64_t &key : result)
+                key = static_cast<int64_t>(rng.next());
+            break;
+
+        case Pattern::Clustered:
+            for (size_t i = 0; i < n; i++)
+            {
+                // Espaçamento entre bases grande o bastante para que as faixas não se sobreponham
+                if (i % CLUSTER_SIZE == 0)
+                    result[i] = static_cast<int64_t>(rng.uniform(uint64_t(1) << 52)) << 10;
+                else
+                    result[i] = result[i - 1] + 1;
+            }
+            break;
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Operações registradas em cargas e traces.
+     */
+    enum class OpType : uint8_t
+    {
+        Insert = 1,
+        Erase = 2,
+        Contains = 3,
+        Successor = 4,
+        Predecessor = 5,
+        Clear = 6,
+    };
+
+    constexpr size_t OP_TYPES = 7; // Maior valor de OpType + 1, para indexar por tipo
+
+    inline const char *to_string(OpType type) noexcept
+    {
+        switch (type)
+        {
+        case OpType::Insert:
+            return "insert";
+        case OpType::Erase:
+            return "erase";
+        case OpType::Contains:
+            return "contains";
+        case OpType::Successor:
+            return "successor";
+        case OpType::Predecessor:
+            return "predecessor";
+        case OpType::Clear:
+            return "clear";
+        }
+
+        return "";
+    }
+
+    struct Operation
+    {
+        OpType type;
+        int64_t key;
+
+        bool operator==(const Operation &) const = default;
+    };
+
+    /**
+     * @brief Inserções de todas as chaves, na ordem dada.
+     */
+    inline std::vector<Operation> inserts(const std::vector<int64_t> &keys)
+    {
+        std::vector<Operation> operations;
+        operations.reserve(keys.size());
+
+        for (int64_t key : keys)
+            operations.push_back({OpType::Insert, key});
+
+        return operations;
+    }
+
+    /**
+     * @brief `count` buscas por chaves de `keys` com popularidade Zipf de expoente `s`.
+     *
+     * As posições no ranking de popularidade são sorteadas, então as chaves mais
+     * buscadas não são as primeiras de `keys`.
+     */
+    inline std::vector<Operation> zipf_lookups(const std::vector<int64_t> &keys, size_t count, double s, uint64_t seed)
+    {
+        if (keys.empty())
+            throw std::invalid_argument("zipf_lookups requer chaves");
+
+        Rng rng(seed);
+        std::vector<int64_t> ranking = keys;
+        shuffle(ranking, rng);
+
+        Zipf zipf(ranking.size(), s);
+        std::vector<Operation> operations(count);
+
+        for (Operation &operation : operations)
+            operation = {OpType::Contains, ranking[zipf(rng) - 1]};
+
+        return operations;
+    }
+
+    /**
+     * @brief Insere `initial` e depois intercala `count` inserções de chaves novas,
+     * remoções e buscas (um terço de cada), mantendo o tamanho do conjunto estável.
+     *
+     * As remoções são de chaves presentes e sorteadas, exercitando o rebalanceamento após
+     * remoções em posições arbitrárias da árvore.
+     */
+    inline std::vector<Operation> churn(const std::vector<int64_t> &initial, size_t count, uint64_t seed)
+    {
+        Rng rng(seed);
+        std::vector<Operation> operations = inserts(initial);
+        operations.reserve(initial.size() + count);
+
+        // Chaves repetidas em `initial` ficam uma única vez em `present`
+        std::vector<int64_t> present = initial;
+        present.reserve(initial.size() + count / 3 + 1);
+        std::sort(present.begin(), present.end());
+        present.erase(std::unique(present.begin(), present.end()), present.end());
+
+        for (size_t i = 0; i < count; i++)
+        {
+            uint64_t choice = rng.uniform(3);
+
+            if (choice == 0 or present.empty())
+            {
+                present.push_back(static_cast<int64_t>(rng.next()));
+                operations.push_back({OpType::Insert, present.back()});
+            }
+            else if (choice == 1)
+            {
+                size_t index = rng.uniform(present.size());
+                operations.push_back({OpType::Erase, present[index]});
+                present[index] = present.back();
+                present.pop_back();
+            }
+            else
+            {
+                operations.push_back({OpType::Contains, present[rng.uniform(present.size())]});
+            }
+        }
+
+        return operations;
+    }
+}
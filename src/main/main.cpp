@@ -1,4 +1,6 @@
 #include <iostream>
+#include <iterator>
+#include <string>
 #include <vector>
 
 #include "set/Set.hpp"
@@ -30,17 +32,20 @@ Set<int> &getConjunto(vector<Set<int>> &conjuntos)
     return conjuntos[index - 1];
 }
 
-void imprimirConjuntos(vector<Set<int>> &conjuntos)
+void imprimirConjuntos(const vector<Set<int>> &conjuntos)
 {
-    std::cout << "-----------------------------------------------------------" << std::endl;
-    std::cout << "Conjuntos Disponíveis:" << std::endl;
+    // Monta a listagem inteira e escreve de uma vez, em vez de uma escrita por chave
+    std::string listagem = "-----------------------------------------------------------\n"
+                           "Conjuntos Disponíveis:\n";
     for (size_t i = 0; i < conjuntos.size(); i++)
     {
-        std::cout << "Conjunto " << i + 1 << ": { ";
-        conjuntos[i].printInOrder();
-        std::cout << "}" << std::endl;
+        listagem += "Conjunto " + std::to_string(i + 1) + ": { ";
+        conjuntos[i].printInOrder(std::back_inserter(listagem));
+        listagem += "}\n";
     }
-    std::cout << "-----------------------------------------------------------" << std::endl;
+    listagem += "-----------------------------------------------------------\n";
+
+    std::cout << listagem << std::flush;
 }
 
 void printConjunto(Set<int> &conjunto)
@@ -4,11 +4,33 @@
 #include <vector>
 #include <algorithm> // Para std::sort, std::set_union etc. para verificação
 #include <stdexcept> // Para std::runtime_error
+#include <thread>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <set>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Os testes compilam a instrumentação de Set para verificar os contadores de stats()
+#define SET_STATS
 
 // Assume que Node.hpp e Set.hpp estão acessíveis.
 // Se estiverem num diretório específico como 'src', ajuste o caminho de inclusão
 // ou garanta que os caminhos de inclusão do seu sistema de compilação estão configurados corretamente.
 #include "set/Set.hpp" // Isto deve incluir Node.hpp conforme a sua estrutura
+#include "concurrentSet/ConcurrentSet.hpp"
+#include "concurrentSet/EpochSet.hpp"
+#include "concurrentSet/OptimisticSet.hpp"
+#include "concurrentSet/ShardedSet.hpp"
+#include "persistentSet/PersistentSet.hpp"
+#include "frozenSet/FrozenSet.hpp"
+#include "serialization/PackedSet.hpp"
+#include "durableSet/DurableSet.hpp"
+#include "workload/RecordingSet.hpp"
+#include "latency/TimedSet.hpp"
+#include "workload/Trace.hpp"
 
 // --- Testes Node ---
 TEST(NodeTest, ConstructorInitializesCorrectly)
@@ -18,6 +40,7 @@ TEST(NodeTest, ConstructorInitializesCorrectly)
     EXPECT_EQ(node1.height, 1); // Altura padrão
     EXPECT_EQ(node1.left, nullptr);
     EXPECT_EQ(node1.right, nullptr);
+    EXPECT_EQ(node1.refs.load(), 1u); // Nó recém-criado pertence a um único dono
 
     Node<int> node2(20, 2, nullptr, nullptr);
     EXPECT_EQ(node2.key, 20);
@@ -72,7 +95,7 @@ protected:
         // Usar uma referência não-const para chamar printInOrder não-const
         Set<int> temp_set = set_to_check; // Requer um construtor de cópia funcional
 
-        std::string actual_output = getPrintOutput(temp_set, static_cast<void (Set<int>::*)()>(&Set<int>::printInOrder));
+        std::string actual_output = getPrintOutput(temp_set, static_cast<void (Set<int>::*)() const>(&Set<int>::printInOrder));
         EXPECT_EQ(actual_output, ss_expected.str()) << "Falha na correspondência da saída de printInOrder.";
         EXPECT_EQ(temp_set.size(), expected_elements.size()) << "Falha na correspondência do tamanho do conjunto.";
         for (int val : expected_elements)
@@ -561,7 +584,7 @@ TEST_F(AVLSetTest, PrintInOrder)
 {
     s = {10, 5, 15, 3, 7};
     // Esperado: 3 5 7 10 15
-    std::string output = getPrintOutput(s, static_cast<void (Set<int>::*)()>(&Set<int>::printInOrder));
+    std::string output = getPrintOutput(s, static_cast<void (Set<int>::*)() const>(&Set<int>::printInOrder));
     EXPECT_EQ(output, "3 5 7 10 15 ");
 }
 
@@ -570,7 +593,7 @@ TEST_F(AVLSetTest, PrintPreOrder)
     s = {10, 5, 15, 3, 7, 12, 17}; // Balanceado: 10 é raiz
     // Esperado para 10 (E:5(E:3 D:7) D:15(E:12 D:17)):
     // 10 5 3 7 15 12 17
-    std::string output = getPrintOutput(s, static_cast<void (Set<int>::*)()>(&Set<int>::printPreOrder));
+    std::string output = getPrintOutput(s, static_cast<void (Set<int>::*)() const>(&Set<int>::printPreOrder));
     EXPECT_EQ(output, "10 5 3 7 15 12 17 ");
 }
 
@@ -579,7 +602,7 @@ TEST_F(AVLSetTest, PrintPostOrder)
     s = {10, 5, 15, 3, 7, 12, 17};
     // Esperado para 10 (E:5(E:3 D:7) D:15(E:12 D:17)):
     // 3 7 5 12 17 15 10
-    std::string output = getPrintOutput(s, static_cast<void (Set<int>::*)()>(&Set<int>::printPostOrder));
+    std::string output = getPrintOutput(s, static_cast<void (Set<int>::*)() const>(&Set<int>::printPostOrder));
     EXPECT_EQ(output, "3 7 5 12 17 15 10 ");
 }
 
@@ -587,14 +610,1794 @@ TEST_F(AVLSetTest, PrintLarge_LevelOrder)
 {
     s = {10, 5, 15, 3, 7, 12, 17};
     // Esperado (Ordem por nível): 10 5 15 3 7 12 17
-    std::string output = getPrintOutput(s, static_cast<void (Set<int>::*)()>(&Set<int>::printLarge));
+    std::string output = getPrintOutput(s, static_cast<void (Set<int>::*)() const>(&Set<int>::printLarge));
     EXPECT_EQ(output, "10 5 15 3 7 12 17 ");
 }
 
 TEST_F(AVLSetTest, PrintEmptySet)
 {
-    EXPECT_EQ(getPrintOutput(s, static_cast<void (Set<int>::*)()>(&Set<int>::printInOrder)), "");
-    EXPECT_EQ(getPrintOutput(s, static_cast<void (Set<int>::*)()>(&Set<int>::printPreOrder)), "");
-    EXPECT_EQ(getPrintOutput(s, static_cast<void (Set<int>::*)()>(&Set<int>::printPostOrder)), "");
-    EXPECT_EQ(getPrintOutput(s, static_cast<void (Set<int>::*)()>(&Set<int>::printLarge)), "");
-}
\ No newline at end of file
+    EXPECT_EQ(getPrintOutput(s, static_cast<void (Set<int>::*)() const>(&Set<int>::printInOrder)), "");
+    EXPECT_EQ(getPrintOutput(s, static_cast<void (Set<int>::*)() const>(&Set<int>::printPreOrder)), "");
+    EXPECT_EQ(getPrintOutput(s, static_cast<void (Set<int>::*)() const>(&Set<int>::printPostOrder)), "");
+    EXPECT_EQ(getPrintOutput(s, static_cast<void (Set<int>::*)() const>(&Set<int>::printLarge)), "");
+}
+
+TEST(PrintOutputTest, StreamsAndIteratorsMatchCout)
+{
+    Set<int> s = {10, 5, 15, 3, 7, 12, 17, -2147483647 - 1, 2147483647};
+
+    std::ostringstream stream;
+    s.printPreOrder(stream);
+
+    std::ostringstream expected;
+    s.for_each([&expected](int key)
+               { expected << key << " "; });
+
+    std::string inOrder;
+    s.printInOrder(std::back_inserter(inOrder));
+    EXPECT_EQ(inOrder, expected.str());
+
+    std::string preOrder;
+    s.printPreOrder(std::back_inserter(preOrder));
+    EXPECT_EQ(preOrder, stream.str());
+
+    // Um conjunto grande atravessa vários blocos do buffer interno
+    Set<long long> large;
+    std::string largeExpected;
+    for (long long i = -50000; i < 50000; i++)
+    {
+        large.insert(i * 1000003);
+        largeExpected += std::to_string(i * 1000003) + " ";
+    }
+    std::ostringstream largeStream;
+    large.printInOrder(largeStream);
+    EXPECT_EQ(largeStream.str(), largeExpected);
+}
+
+TEST(PrintOutputTest, KeepsStreamFormattingAndNonIntegerKeys)
+{
+    Set<int> numbers = {255, 16, 1};
+    std::ostringstream hex;
+    hex << std::hex << std::showbase;
+    numbers.printInOrder(hex);
+    EXPECT_EQ(hex.str(), "0x1 0x10 0xff ");
+
+    Set<double> reals = {0.1234567, 1.5, -3.0};
+    std::ostringstream realStream;
+    reals.printInOrder(realStream);
+    EXPECT_EQ(realStream.str(), "-3 0.123457 1.5 ");
+
+    Set<std::string> words = {"pera", "banana", "maçã"};
+    std::string wordOutput;
+    words.printLarge(std::back_inserter(wordOutput));
+    EXPECT_EQ(wordOutput, "maçã banana pera ");
+
+    Set<char> letters = {'b', 'a'};
+    std::ostringstream letterStream;
+    letters.printPostOrder(letterStream);
+    EXPECT_EQ(letterStream.str(), "a b ");
+}
+
+// --- Travessias genéricas ---
+TEST(TraversalTest, VisitsInEachOrderAndStopsEarly)
+{
+    Set<int> s = {10, 5, 15, 3, 7, 12, 17};
+
+    std::vector<int> inorder, preorder, postorder, levelorder;
+    EXPECT_TRUE(s.for_each_inorder([&inorder](int key)
+                                   { inorder.push_back(key); }));
+    EXPECT_TRUE(s.for_each_preorder([&preorder](int key)
+                                    { preorder.push_back(key); }));
+    EXPECT_TRUE(s.for_each_postorder([&postorder](int key)
+                                     { postorder.push_back(key); }));
+    EXPECT_TRUE(s.for_each_levelorder([&levelorder](int key)
+                                      { levelorder.push_back(key); }));
+
+    EXPECT_EQ(inorder, (std::vector<int>{3, 5, 7, 10, 12, 15, 17}));
+    EXPECT_EQ(preorder, (std::vector<int>{10, 5, 3, 7, 15, 12, 17}));
+    EXPECT_EQ(postorder, (std::vector<int>{3, 7, 5, 12, 17, 15, 10}));
+    EXPECT_EQ(levelorder, (std::vector<int>{10, 5, 15, 3, 7, 12, 17}));
+
+    // Retornar false interrompe a travessia
+    std::vector<int> firstThree;
+    EXPECT_FALSE(s.for_each_levelorder([&firstThree](int key)
+                                       {
+                                           firstThree.push_back(key);
+                                           return firstThree.size() < 3; }));
+    EXPECT_EQ(firstThree, (std::vector<int>{10, 5, 15}));
+
+    int visited = 0;
+    EXPECT_FALSE(s.for_each_inorder([&visited](int key)
+                                    {
+                                        visited++;
+                                        return key < 7; }));
+    EXPECT_EQ(visited, 3);
+
+    Set<int> empty;
+    EXPECT_TRUE(empty.for_each_postorder([](int)
+                                         { return false; }));
+}
+
+TEST(TraversalTest, LevelOrderMatchesQueueOnLargeTree)
+{
+    Set<int> s;
+    std::vector<int> keys(20000);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+    for (int key : keys)
+        s.insert(key);
+    for (int key = 0; key < 20000; key += 3)
+        s.erase(key);
+
+    // Referência: pré-ordem reconstrói a árvore, e uma fila dá a ordem por nível
+    std::vector<int> preorder;
+    s.for_each_preorder([&preorder](int key)
+                        { preorder.push_back(key); });
+
+    struct Ref
+    {
+        int key;
+        int left{-1}, right{-1};
+    };
+    std::vector<Ref> nodes;
+    auto build = [&](auto &self, size_t &i, int low, int high) -> int
+    {
+        if (i == preorder.size() or preorder[i] < low or preorder[i] > high)
+            return -1;
+        int index = static_cast<int>(nodes.size());
+        nodes.push_back({preorder[i++]});
+        int left = self(self, i, low, nodes[index].key - 1);
+        nodes[index].left = left;
+        int right = self(self, i, nodes[index].key + 1, high);
+        nodes[index].right = right;
+        return index;
+    };
+    size_t position = 0;
+    int rootIndex = build(build, position, INT32_MIN, INT32_MAX);
+
+    std::vector<int> expected;
+    std::vector<int> queue{rootIndex};
+    for (size_t i = 0; i < queue.size(); i++)
+    {
+        expected.push_back(nodes[queue[i]].key);
+        if (nodes[queue[i]].left != -1)
+            queue.push_back(nodes[queue[i]].left);
+        if (nodes[queue[i]].right != -1)
+            queue.push_back(nodes[queue[i]].right);
+    }
+
+    std::vector<int> levelorder;
+    s.for_each_levelorder([&levelorder](int key)
+                          { levelorder.push_back(key); });
+    EXPECT_EQ(levelorder, expected);
+
+    long long sum = 0;
+    size_t count = 0;
+    s.for_each_postorder([&](int key)
+                         { sum += key; count++; });
+    EXPECT_EQ(count, s.size());
+    EXPECT_EQ(sum, std::accumulate(preorder.begin(), preorder.end(), 0LL));
+}
+
+// --- Geradores (corrotinas) ---
+TEST(GeneratorTest, TraversalsAndRangesMatchVisitors)
+{
+    Set<int> s;
+    for (int i = 0; i < 1000; i += 3)
+        s.insert(i);
+
+    std::vector<int> expectedIn, expectedLevel;
+    s.for_each_inorder([&expectedIn](int key)
+                       { expectedIn.push_back(key); });
+    s.for_each_levelorder([&expectedLevel](int key)
+                          { expectedLevel.push_back(key); });
+
+    std::vector<int> in, level;
+    for (int key : s.inorder())
+        in.push_back(key);
+    for (int key : s.levelorder())
+        level.push_back(key);
+    EXPECT_EQ(in, expectedIn);
+    EXPECT_EQ(level, expectedLevel);
+
+    std::vector<int> range;
+    for (int key : s.range(100, 130)) // 100 e 130 não pertencem ao conjunto
+        range.push_back(key);
+    EXPECT_EQ(range, (std::vector<int>{102, 105, 108, 111, 114, 117, 120, 123, 126, 129}));
+
+    range.clear();
+    for (int key : s.range(990, 5000))
+        range.push_back(key);
+    EXPECT_EQ(range, (std::vector<int>{990, 993, 996, 999}));
+
+    EXPECT_EQ(s.range(500, 400).next(), nullptr);
+    EXPECT_EQ(s.range(-10, -1).next(), nullptr);
+    EXPECT_EQ(Set<int>().inorder().next(), nullptr);
+    EXPECT_EQ(Set<int>().levelorder().next(), nullptr);
+}
+
+TEST(GeneratorTest, InterleavesSetsAndPropagatesExceptions)
+{
+    Set<int> evens, odds;
+    for (int i = 0; i < 200; i++)
+        (i % 2 == 0 ? evens : odds).insert(i);
+
+    // Intercala dois conjuntos sem materializá-los
+    Generator<int> a = evens.inorder();
+    Generator<int> b = odds.inorder();
+    const int *x = a.next();
+    const int *y = b.next();
+    std::vector<int> merged;
+    while (x != nullptr or y != nullptr)
+    {
+        if (y == nullptr or (x != nullptr and *x < *y))
+        {
+            merged.push_back(*x);
+            x = a.next();
+        }
+        else
+        {
+            merged.push_back(*y);
+            y = b.next();
+        }
+    }
+    std::vector<int> expected(200);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(merged, expected);
+
+    // Parar no meio destrói a corrotina suspensa
+    int seen = 0;
+    for (int key : evens.inorder())
+    {
+        if (key > 10)
+            break;
+        seen++;
+    }
+    EXPECT_EQ(seen, 6);
+
+    auto failing = [](int limit) -> Generator<int>
+    {
+        for (int i = 0; i < limit; i++)
+            co_yield i;
+        throw std::runtime_error("falha no gerador");
+    };
+    Generator<int> g = failing(2);
+    EXPECT_EQ(*g.next(), 0);
+    EXPECT_EQ(*g.next(), 1);
+    EXPECT_THROW(g.next(), std::runtime_error);
+    EXPECT_EQ(g.next(), nullptr);
+}
+
+// --- Exibição da árvore (bshow) ---
+TEST(BshowTest, RendersTreeToStream)
+{
+    Set<int> s = {10, 5, 15, 3, 7, 12, 17, 1};
+
+    std::ostringstream out;
+    s.bshow(out);
+    EXPECT_EQ(out.str(),
+              "    ┌───17\n"
+              "┌───15\n"
+              "│   └───12\n"
+              "10\n"
+              "│   ┌───7\n"
+              "└───5\n"
+              "    │   ┌───#\n"
+              "    └───3\n"
+              "        └───1\n");
+
+    std::stringstream captured;
+    std::streambuf *old_cout = std::cout.rdbuf(captured.rdbuf());
+    s.bshow();
+    std::cout.rdbuf(old_cout);
+    EXPECT_EQ(captured.str(), out.str());
+
+    std::ostringstream empty;
+    Set<int>().bshow(empty);
+    EXPECT_EQ(empty.str(), "#\n");
+}
+
+TEST(BshowTest, DepthAndNodeLimits)
+{
+    Set<int> s = {10, 5, 15, 3, 7, 12, 17, 1};
+
+    std::ostringstream shallow;
+    s.bshow(shallow, 1);
+    EXPECT_EQ(shallow.str(),
+              "┌───15 ...\n"
+              "10\n"
+              "└───5 ...\n");
+
+    std::ostringstream few;
+    s.bshow(few, SIZE_MAX, 3);
+    EXPECT_EQ(few.str(),
+              "    ┌───17\n"
+              "┌───15\n"
+              "│   └───12\n"
+              "...\n");
+
+    // Árvore grande: exatamente 1000 linhas com chaves, além das de filhos ausentes ("#")
+    Set<int> large;
+    for (int i = 0; i < 100000; i++)
+        large.insert(i);
+    std::ostringstream limited;
+    large.bshow(limited, SIZE_MAX, 1000);
+
+    std::istringstream lines(limited.str());
+    std::string line, last;
+    int keys = 0;
+    while (std::getline(lines, line))
+    {
+        if (!line.empty() and std::isdigit(static_cast<unsigned char>(line.back())))
+            keys++;
+        last = line;
+    }
+    EXPECT_EQ(keys, 1000);
+    EXPECT_EQ(last, "...");
+}
+
+// --- Filtro de Bloom ---
+TEST_F(AVLSetTest, FilterHasNoFalseNegatives)
+{
+    s.enable_filter();
+    for (int i = 0; i < 1000; i += 2)
+        s.insert(i);
+
+    EXPECT_TRUE(s.has_filter());
+    for (int i = 0; i < 1000; i += 2)
+        EXPECT_TRUE(s.contains(i));
+
+    for (int i = 1; i < 1000; i += 2)
+        EXPECT_FALSE(s.contains(i));
+
+    BloomFilterStats stats = s.filter_stats();
+    EXPECT_EQ(stats.queries, 1000);
+    EXPECT_EQ(stats.negatives + stats.false_positives, 500);
+    EXPECT_LT(stats.observed_fpr, 0.1);
+    EXPECT_GT(stats.negatives, 0u);
+}
+
+TEST_F(AVLSetTest, FilterRebuildsAfterErases)
+{
+    for (int i = 0; i < 1000; i++)
+        s.insert(i);
+
+    s.enable_filter();
+    EXPECT_EQ(s.filter_stats().rebuilds, 0);
+
+    for (int i = 0; i < 500; i++)
+        s.erase(i);
+
+    BloomFilterStats stats = s.filter_stats();
+    EXPECT_GE(stats.rebuilds, 1u);
+    EXPECT_LE(stats.erases_since_rebuild, 500u);
+
+    for (int i = 500; i < 1000; i++)
+        EXPECT_TRUE(s.contains(i));
+    for (int i = 0; i < 500; i++)
+        EXPECT_FALSE(s.contains(i));
+}
+
+TEST_F(AVLSetTest, FilterIsCopiedAndCleared)
+{
+    s = {1, 2, 3};
+    s.enable_filter(16.0);
+
+    Set<int> s_copy(s);
+    EXPECT_TRUE(s_copy.has_filter());
+    EXPECT_TRUE(s_copy.contains(2));
+    EXPECT_FALSE(s_copy.contains(4));
+
+    s.clear();
+    EXPECT_FALSE(s.contains(1));
+    s.insert(7);
+    EXPECT_TRUE(s.contains(7));
+
+    s.disable_filter();
+    EXPECT_FALSE(s.has_filter());
+    EXPECT_THROW(s.filter_stats(), std::runtime_error);
+}
+
+// --- Mínimo/Máximo em cache e pop_min/pop_max ---
+TEST_F(AVLSetTest, CachedExtremesSurviveErase)
+{
+    s = {10, 20};
+    s.erase(10); // O nó de 20 é removido via remove_successor e sua chave sobe para a raiz
+    EXPECT_EQ(s.minimum(), 20);
+    EXPECT_EQ(s.maximum(), 20);
+
+    s = {20, 10, 30, 5, 15, 25, 35};
+    s.erase(5);
+    s.erase(35);
+    EXPECT_EQ(s.minimum(), 10);
+    EXPECT_EQ(s.maximum(), 30);
+
+    s.erase(20); // Remoção da raiz com dois filhos
+    EXPECT_EQ(s.minimum(), 10);
+    EXPECT_EQ(s.maximum(), 30);
+}
+
+TEST_F(AVLSetTest, PopMinPopMax)
+{
+    s = {5, 3, 8, 1, 4, 7, 9, 2, 6};
+
+    EXPECT_EQ(s.pop_min(), 1);
+    EXPECT_EQ(s.pop_max(), 9);
+    EXPECT_EQ(s.pop_min(), 2);
+    EXPECT_EQ(s.size(), 6);
+    EXPECT_EQ(s.minimum(), 3);
+    EXPECT_EQ(s.maximum(), 8);
+    verifyElements(s, {3, 4, 5, 6, 7, 8});
+
+    std::vector<int> drained;
+    while (!s.empty())
+        drained.push_back(s.pop_min());
+
+    EXPECT_EQ(drained, std::vector<int>({3, 4, 5, 6, 7, 8}));
+    EXPECT_THROW(s.pop_min(), std::runtime_error);
+    EXPECT_THROW(s.pop_max(), std::runtime_error);
+}
+
+TEST_F(AVLSetTest, TryMinTryMax)
+{
+    EXPECT_FALSE(s.try_min().has_value());
+    EXPECT_FALSE(s.try_max().has_value());
+
+    for (int i = 100; i > 0; i--)
+        s.insert(i);
+
+    EXPECT_EQ(s.try_min(), 1);
+    EXPECT_EQ(s.try_max(), 100);
+
+    for (int i = 1; i <= 50; i++)
+        s.erase(i);
+
+    EXPECT_EQ(s.try_min(), 51);
+    EXPECT_EQ(s.try_max(), 100);
+
+    Set<int> other = {-1};
+    s.swap(other);
+    EXPECT_EQ(s.try_min(), -1);
+    EXPECT_EQ(other.try_min(), 51);
+}
+
+// --- Consultas sem exceção ---
+TEST_F(AVLSetTest, FindNextFindPrev)
+{
+    s = {10, 5, 15, 3, 7, 12, 17};
+
+    EXPECT_EQ(s.find_next(3), 5);
+    EXPECT_EQ(s.find_next(10), 12);
+    EXPECT_EQ(s.find_next(11), 12); // Chave ausente
+    EXPECT_EQ(s.find_next(-100), 3);
+    EXPECT_FALSE(s.find_next(17).has_value());
+    EXPECT_FALSE(s.find_next(100).has_value());
+
+    EXPECT_EQ(s.find_prev(5), 3);
+    EXPECT_EQ(s.find_prev(12), 10);
+    EXPECT_EQ(s.find_prev(11), 10); // Chave ausente
+    EXPECT_EQ(s.find_prev(100), 17);
+    EXPECT_FALSE(s.find_prev(3).has_value());
+    EXPECT_FALSE(s.find_prev(-100).has_value());
+}
+
+TEST_F(AVLSetTest, FindNextFindPrevOnEmptySet)
+{
+    EXPECT_FALSE(s.find_next(0).has_value());
+    EXPECT_FALSE(s.find_prev(0).has_value());
+    EXPECT_TRUE(noexcept(s.find_next(0)));
+    EXPECT_TRUE(noexcept(s.try_min()));
+}
+
+// --- Contadores de instrumentação (SET_STATS) ---
+TEST(SetStatsTest, CountsRotationsAllocationsAndDepth)
+{
+    static_assert(std::is_empty_v<StatsCounters<false>>, "sem SET_STATS os contadores nao ocupam memoria");
+
+    Set<int> ascending;
+    for (int i = 0; i < 1024; i++)
+        ascending.insert(i);
+
+    SetStats stats = ascending.stats();
+    EXPECT_EQ(stats.allocations, 1024u);
+    EXPECT_EQ(stats.right_rotations, 0u);
+    EXPECT_EQ(stats.double_rotations, 0u);
+    EXPECT_EQ(stats.single_rotations, stats.left_rotations);
+    EXPECT_GT(stats.left_rotations, 1000u);
+    EXPECT_LE(stats.max_depth, 11u);
+    EXPECT_GT(stats.comparisons, 1024u * 8);
+
+    // Inserções sempre no meio de um intervalo exigem rotações duplas
+    Set<int> alternating;
+    for (int i = 0; i < 100; i++)
+        alternating.insert(i % 2 == 0 ? i / 2 : 99 - i / 2);
+    stats = alternating.stats();
+    EXPECT_GT(stats.double_rotations, 0u);
+    EXPECT_EQ(stats.left_rotations + stats.right_rotations, stats.single_rotations + 2 * stats.double_rotations);
+
+    ascending.reset_stats();
+    EXPECT_TRUE(ascending.contains(1023));
+    EXPECT_EQ(ascending.stats().comparisons, ascending.stats().max_depth);
+    EXPECT_EQ(ascending.stats().allocations, 0u);
+
+    Set<int> copy = ascending;
+    EXPECT_EQ(copy.stats().comparisons, 0u);
+    copy.erase(0); // Descompartilha o caminho até a chave antes de removê-la
+    EXPECT_GT(copy.stats().allocations, 0u);
+    EXPECT_EQ(copy.stats().frees, 1u);
+
+    for (int i = 0; i < 1024; i++)
+        ascending.erase(i);
+    EXPECT_EQ(ascending.stats().frees, 1024u);
+}
+
+TEST(SetStatsTest, CopyOnWriteCheckIsNotCounted)
+{
+    Set<int> original;
+    for (int i = 0; i < 1023; i++)
+        original.insert(i);
+    size_t height = original.shape_stats().height;
+
+    Set<int> copy = original;
+    copy.reset_stats();
+    copy.erase(0);
+    EXPECT_LE(copy.stats().max_depth, height);
+    EXPECT_LE(copy.stats().comparisons, height);
+
+    Set<int> absent = original;
+    absent.reset_stats();
+    absent.erase(5000);
+    absent.insert(500);
+    EXPECT_LE(absent.stats().max_depth, height);
+    EXPECT_LE(absent.stats().comparisons, 2 * height);
+    EXPECT_EQ(absent.stats().allocations, 0u);
+}
+
+TEST(SetStatsTest, ThreadStatsAreSeparatePerThread)
+{
+    Set<long> set;
+    Set<long>::reset_thread_stats();
+    set.insert(1);
+    set.insert(2);
+    set.insert(3);
+    EXPECT_EQ(Set<long>::thread_stats().allocations, 3u);
+    EXPECT_EQ(Set<long>::thread_stats().single_rotations, 1u);
+
+    SetStats worker_stats;
+    std::thread worker([&]()
+                       {
+                           Set<long> other{10, 20};
+                           other.contains(20);
+                           worker_stats = Set<long>::thread_stats(); });
+    worker.join();
+
+    EXPECT_EQ(worker_stats.allocations, 2u);
+    EXPECT_EQ(Set<long>::thread_stats().allocations, 3u);
+
+    Set<long>::reset_thread_stats();
+    EXPECT_EQ(Set<long>::thread_stats().allocations, 0u);
+    EXPECT_EQ(set.stats().allocations, 3u);
+}
+
+// --- Forma da árvore e memória ---
+TEST(ShapeStatsTest, PerfectTreeShape)
+{
+    EXPECT_EQ(Set<int>().shape_stats().nodes, 0u);
+    EXPECT_EQ(Set<int>().shape_stats().height, 0u);
+    EXPECT_EQ(Set<int>().shape_stats().heap_bytes, 0u);
+
+    std::vector<int> keys(127);
+    std::iota(keys.begin(), keys.end(), 0);
+    Set<int> set = Set<int>::build_parallel(keys, 1); // Árvore perfeita de altura 7
+
+    ShapeStats stats = set.shape_stats();
+    EXPECT_EQ(stats.nodes, 127u);
+    EXPECT_EQ(stats.height, 7u);
+    EXPECT_EQ(stats.depth_histogram, (std::vector<size_t>{1, 2, 4, 8, 16, 32, 64}));
+    EXPECT_EQ(stats.balance_factors[1], 127u);
+    EXPECT_EQ(stats.unbalanced, 0u);
+
+    // (1*1 + 2*2 + 3*4 + ... + 7*64) / 127
+    EXPECT_NEAR(stats.average_path_length, 769.0 / 127.0, 1e-9);
+    EXPECT_EQ(stats.node_bytes, 127 * allocation_size(sizeof(Node<int>)));
+    EXPECT_EQ(stats.key_bytes, 0u);
+    EXPECT_EQ(stats.shared_nodes, 0u);
+
+    set.enable_filter();
+    EXPECT_GT(set.shape_stats().filter_bytes, 0u);
+    EXPECT_EQ(set.shape_stats().heap_bytes, stats.node_bytes + set.shape_stats().filter_bytes);
+}
+
+TEST(ShapeStatsTest, AdversarialInsertsStayBalancedAndCountKeyMemory)
+{
+    Set<int> set;
+    for (int i = 0; i < 10'000; i++)
+        set.insert(i % 2 == 0 ? i / 2 : 9'999 - i / 2);
+
+    ShapeStats stats = set.shape_stats();
+    EXPECT_EQ(stats.nodes, 10'000u);
+    EXPECT_EQ(stats.unbalanced, 0u);
+    EXPECT_EQ(stats.balance_factors[0] + stats.balance_factors[1] + stats.balance_factors[2], 10'000u);
+    EXPECT_LE(stats.height, 19u); // Limite da AVL: 1,44 log2(n + 2)
+    EXPECT_LT(stats.average_path_length, static_cast<double>(stats.height));
+
+    Set<std::string> strings{"a", std::string(200, 'x')};
+    ShapeStats string_stats = strings.shape_stats();
+    EXPECT_EQ(string_stats.key_bytes, allocation_size(201)); // A string curta fica dentro do objeto
+    EXPECT_EQ(string_stats.heap_bytes, string_stats.node_bytes + string_stats.key_bytes);
+
+    Set<std::string> copy = strings;
+    EXPECT_EQ(copy.shape_stats().shared_nodes, 1u); // Apenas a raiz é referenciada pelas duas cópias
+}
+
+// --- Construção paralela ---
+TEST(BuildParallelTest, MatchesSequentialInsertion)
+{
+    std::vector<int> values;
+    for (int i = 0; i < 100000; i++)
+        values.push_back((i * 7919) % 60000); // Fora de ordem e com duplicatas
+
+    Set<int> built = Set<int>::build_parallel(values, 4);
+    std::set<int> expected(values.begin(), values.end());
+
+    EXPECT_EQ(built.size(), expected.size());
+    EXPECT_EQ(built.minimum(), *expected.begin());
+    EXPECT_EQ(built.maximum(), *expected.rbegin());
+
+    std::vector<int> keys;
+    built.for_each([&keys](int key)
+                   { keys.push_back(key); });
+    EXPECT_TRUE(std::equal(keys.begin(), keys.end(), expected.begin(), expected.end()));
+
+    // A árvore construída continua sendo uma AVL válida para modificações
+    for (int i = 0; i < 60000; i += 3)
+        built.erase(i);
+    built.insert(-1);
+    EXPECT_EQ(built.size(), 40001);
+    EXPECT_EQ(built.pop_min(), -1);
+    EXPECT_EQ(built.minimum(), 1);
+}
+
+TEST(BuildParallelTest, SmallAndEmptyInputs)
+{
+    std::vector<int> empty;
+    Set<int> none = Set<int>::build_parallel(empty, 8);
+    EXPECT_TRUE(none.empty());
+    EXPECT_FALSE(none.try_min().has_value());
+
+    Set<int> one = Set<int>::build_parallel(std::vector<int>{5, 5, 5}, 0);
+    EXPECT_EQ(one.size(), 1);
+    EXPECT_EQ(one.minimum(), 5);
+    EXPECT_EQ(one.maximum(), 5);
+
+    Set<int> sorted = Set<int>::from_sorted({1, 3, 5, 7}, 2);
+    EXPECT_EQ(sorted.size(), 4);
+    EXPECT_TRUE(sorted.contains(5));
+    EXPECT_THROW(Set<int>::from_sorted({1, 3, 3}), std::invalid_argument);
+}
+
+/**
+ * @brief Chave que lança na cópia ou na comparação depois de um número configurável de
+ * chamadas e conta as instâncias vivas, para detectar vazamentos.
+ */
+struct FragileKey
+{
+    int value;
+
+    static inline std::atomic<long> live{0};
+    static inline std::atomic<long> copies_left{-1};
+    static inline std::atomic<long> comparisons_left{-1};
+
+    explicit FragileKey(int value) : value(value) { live++; }
+    FragileKey(FragileKey &&other) noexcept : value(other.value) { live++; }
+    FragileKey &operator=(FragileKey &&other) noexcept = default;
+    FragileKey &operator=(const FragileKey &other) = default;
+    ~FragileKey() { live--; }
+
+    FragileKey(const FragileKey &other) : value(other.value)
+    {
+        if (copies_left.fetch_sub(1) == 0)
+            throw std::bad_alloc();
+        live++;
+    }
+
+    bool operator<(const FragileKey &other) const
+    {
+        if (comparisons_left.fetch_sub(1) == 0)
+            throw std::runtime_error("comparacao falhou");
+        return value < other.value;
+    }
+
+    bool operator>(const FragileKey &other) const { return other < *this; }
+    bool operator==(const FragileKey &other) const { return value == other.value; }
+};
+
+template <>
+struct std::hash<FragileKey>
+{
+    size_t operator()(const FragileKey &key) const noexcept { return std::hash<int>{}(key.value); }
+};
+
+TEST(BuildParallelTest, ExceptionsFreeNodesAndJoinThreads)
+{
+    std::vector<FragileKey> keys;
+    for (int i = 0; i < 100000; i++)
+        keys.emplace_back(i);
+    long before = FragileKey::live;
+
+    // Falha de alocação dentro de uma das threads de montagem
+    FragileKey::copies_left = 60000;
+    EXPECT_THROW(Set<FragileKey>::from_sorted(keys, 4), std::bad_alloc);
+    FragileKey::copies_left = -1;
+    EXPECT_EQ(FragileKey::live, before);
+
+    // Comparação que lança durante a ordenação paralela
+    std::reverse(keys.begin(), keys.end());
+    FragileKey::comparisons_left = 200000;
+    EXPECT_THROW(Set<FragileKey>::build_parallel(keys, 4), std::runtime_error);
+    FragileKey::comparisons_left = -1;
+    EXPECT_EQ(FragileKey::live, before);
+
+    Set<FragileKey> built = Set<FragileKey>::build_parallel(keys, 4);
+    EXPECT_EQ(built.size(), keys.size());
+    EXPECT_EQ(built.minimum().value, 0);
+}
+
+// --- Serialização binária ---
+TEST(SerializationTest, RoundTripIntegersAndStrings)
+{
+    Set<int> numbers;
+    for (int i = -500; i < 500; i += 3)
+        numbers.insert(i);
+
+    std::stringstream buffer(std::ios::in | std::ios::out | std::ios::binary);
+    numbers.save(buffer);
+
+    Set<int> loaded = {42}; // O conteúdo anterior é substituído
+    loaded.load(buffer);
+    EXPECT_EQ(loaded.size(), numbers.size());
+    EXPECT_EQ(loaded.minimum(), -500);
+    EXPECT_EQ(loaded.maximum(), 499);
+    EXPECT_FALSE(loaded.contains(42));
+    EXPECT_TRUE(loaded.contains(1));
+
+    Set<std::string> words = {"pera", "", "maçã", "banana com espaço"};
+    std::stringstream wordBuffer(std::ios::in | std::ios::out | std::ios::binary);
+    words.save(wordBuffer);
+
+    Set<std::string> loadedWords;
+    loadedWords.load(wordBuffer);
+    EXPECT_EQ(loadedWords.size(), 4);
+    EXPECT_TRUE(loadedWords.contains(""));
+    EXPECT_TRUE(loadedWords.contains("banana com espaço"));
+    EXPECT_EQ(loadedWords.maximum(), "pera");
+
+    Set<int> empty;
+    std::stringstream emptyBuffer(std::ios::in | std::ios::out | std::ios::binary);
+    empty.save(emptyBuffer);
+    loaded.load(emptyBuffer);
+    EXPECT_TRUE(loaded.empty());
+}
+
+TEST(SerializationTest, RejectsInvalidInput)
+{
+    Set<int> numbers = {1, 2, 3, 4, 5};
+    std::stringstream buffer(std::ios::in | std::ios::out | std::ios::binary);
+    numbers.save(buffer);
+    std::string bytes = buffer.str();
+
+    Set<int> target = {99};
+
+    // Tipo de chave diferente
+    std::stringstream asDouble(bytes);
+    Set<double> doubles;
+    EXPECT_THROW(doubles.load(asDouble), std::runtime_error);
+
+    // Byte de uma chave alterado: checksum não confere
+    std::string corrupted = bytes;
+    corrupted[sizeof(SetFileHeader) + 1] ^= 0x40;
+    std::stringstream corruptedStream(corrupted);
+    EXPECT_THROW(target.load(corruptedStream), std::runtime_error);
+
+    // Arquivo truncado
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 2));
+    EXPECT_THROW(target.load(truncated), std::runtime_error);
+
+    // Não é um arquivo de Set
+    std::stringstream garbage("isto nao e um arquivo de Set, apenas texto qualquer");
+    EXPECT_THROW(target.load(garbage), std::runtime_error);
+
+    // Em caso de erro o conjunto não é alterado
+    EXPECT_EQ(target.size(), 1);
+    EXPECT_TRUE(target.contains(99));
+
+    EXPECT_THROW(target.load(std::string("/caminho/que/nao/existe.bin")), std::runtime_error);
+}
+
+TEST(SerializationTest, SaveAndLoadFile)
+{
+    std::string path = (std::filesystem::temp_directory_path() / "avl_set_test.bin").string();
+
+    Set<long long> big;
+    for (long long i = 0; i < 20000; i++)
+        big.insert(i * i);
+    big.save(path);
+
+    Set<long long> loaded;
+    loaded.load(path);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(loaded.size(), 20000);
+    EXPECT_EQ(loaded.maximum(), 19999LL * 19999LL);
+
+    std::vector<long long> keys;
+    loaded.for_each([&keys](long long key)
+                    { keys.push_back(key); });
+    for (long long i = 0; i < 20000; i++)
+        ASSERT_EQ(keys[i], i * i);
+}
+
+TEST(SerializationTest, LoadStopsAtEndOfSet)
+{
+    Set<int> first;
+    for (int i = 0; i < 50000; i++)
+        first.insert(i);
+    Set<std::string> second = {"a", "bb", "ccc"};
+
+    std::stringstream buffer(std::ios::in | std::ios::out | std::ios::binary);
+    first.save(buffer);
+    second.save(buffer);
+    buffer << "TRAILER";
+
+    Set<int> x;
+    Set<std::string> y;
+    x.load(buffer);
+    y.load(buffer);
+
+    EXPECT_EQ(x.size(), 50000);
+    EXPECT_EQ(x.maximum(), 49999);
+    EXPECT_EQ(y.size(), 3);
+    EXPECT_TRUE(y.contains("bb"));
+
+    std::string rest;
+    buffer >> rest;
+    EXPECT_EQ(rest, "TRAILER");
+}
+
+// --- PackedSet (deltas empacotados em bits por bloco) ---
+TEST(PackedSetTest, DenseSetCompressesToFewBytes)
+{
+    Set<int> dense = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    PackedSet<int> packed(dense);
+
+    std::stringstream buffer(std::ios::in | std::ios::out | std::ios::binary);
+    packed.save(buffer);
+    EXPECT_LE(buffer.str().size(), 16u);
+
+    PackedSet<int> loaded = PackedSet<int>::load(buffer);
+    EXPECT_EQ(loaded.size(), 10);
+    EXPECT_TRUE(loaded.contains(1));
+    EXPECT_TRUE(loaded.contains(10));
+    EXPECT_FALSE(loaded.contains(0));
+    EXPECT_FALSE(loaded.contains(11));
+    Set<int> restored = loaded.to_set();
+    EXPECT_EQ(restored.size(), 10);
+    EXPECT_EQ(restored.minimum(), 1);
+    EXPECT_EQ(restored.maximum(), 10);
+
+    std::string bytes = buffer.str();
+    bytes[bytes.size() / 2] ^= 1;
+    std::stringstream corrupted(bytes, std::ios::in | std::ios::binary);
+    EXPECT_THROW(PackedSet<int>::load(corrupted), std::runtime_error);
+
+    std::stringstream wrongType(buffer.str(), std::ios::in | std::ios::binary);
+    EXPECT_THROW(PackedSet<uint64_t>::load(wrongType), std::runtime_error);
+
+    // Vários conjuntos no mesmo fluxo: cada load consome apenas o seu
+    Set<int> sparse;
+    for (int i = 0; i < 1000; i++)
+        sparse.insert(i * 37);
+
+    std::stringstream combined(std::ios::in | std::ios::out | std::ios::binary);
+    packed.save(combined);
+    PackedSet<int>(sparse).save(combined);
+    combined << "TRAILER";
+
+    EXPECT_EQ(PackedSet<int>::load(combined).size(), 10);
+    EXPECT_EQ(PackedSet<int>::load(combined).to_set().maximum(), 999 * 37);
+    std::string rest;
+    combined >> rest;
+    EXPECT_EQ(rest, "TRAILER");
+}
+
+TEST(PackedSetTest, QueriesAndRangesMatchSourceSet)
+{
+    Set<int64_t> source;
+    std::set<int64_t> expected;
+    uint64_t state = 12345;
+    for (int i = 0; i < 5000; i++)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int64_t key = static_cast<int64_t>(state >> 20) - (int64_t(1) << 43);
+        source.insert(key);
+        expected.insert(key);
+    }
+    source.insert(INT64_MIN);
+    source.insert(INT64_MAX);
+    expected.insert(INT64_MIN);
+    expected.insert(INT64_MAX);
+
+    std::stringstream buffer(std::ios::in | std::ios::out | std::ios::binary);
+    PackedSet<int64_t>(source).save(buffer);
+    PackedSet<int64_t> packed = PackedSet<int64_t>::load(buffer);
+    ASSERT_EQ(packed.size(), expected.size());
+
+    for (int64_t key : expected)
+    {
+        EXPECT_TRUE(packed.contains(key));
+        if (key != INT64_MAX and !expected.count(key + 1))
+        {
+            EXPECT_FALSE(packed.contains(key + 1));
+        }
+    }
+
+    auto it = std::next(expected.begin(), 1000);
+    int64_t low = *it - 1, high = *std::next(it, 700);
+    std::vector<int64_t> range;
+    packed.for_each_in_range(low, high, [&range](int64_t key)
+                             { range.push_back(key); });
+    EXPECT_EQ(range, std::vector<int64_t>(expected.lower_bound(low), expected.upper_bound(high)));
+
+    std::vector<int64_t> all;
+    packed.for_each([&all](int64_t key)
+                    { all.push_back(key); });
+    EXPECT_EQ(all, std::vector<int64_t>(expected.begin(), expected.end()));
+}
+
+// --- DurableSet (log de escrita antecipada e recuperação) ---
+TEST(DurableSetTest, RecoversFromCheckpointAndLog)
+{
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "durable_set_test_recovery";
+    std::filesystem::remove_all(dir);
+
+    {
+        DurableSet<int> set(dir.string());
+        for (int i = 0; i < 100; i++)
+            set.insert(i);
+        set.checkpoint();
+        EXPECT_EQ(set.pending_count(), 0);
+
+        for (int i = 0; i < 100; i += 2)
+            set.erase(i);
+        set.insert(500);
+    } // O destrutor grava os registros pendentes
+
+    {
+        DurableSet<int> set(dir.string());
+        EXPECT_EQ(set.size(), 51);
+        EXPECT_TRUE(set.contains(500));
+        EXPECT_FALSE(set.contains(2));
+        EXPECT_TRUE(set.contains(99));
+
+        set.insert(1000);
+        set.sync();
+        set.insert(2000);
+        set.sync();
+    }
+
+    // Simula uma falha no meio da última escrita: o registro incompleto é descartado
+    std::filesystem::path log = dir / "wal";
+    std::filesystem::resize_file(log, std::filesystem::file_size(log) - 2);
+
+    {
+        DurableSet<int> set(dir.string());
+        EXPECT_TRUE(set.contains(1000));
+        EXPECT_FALSE(set.contains(2000));
+        EXPECT_EQ(set.log_size(), std::filesystem::file_size(log));
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(DurableSetTest, GroupCommitAndAutomaticCheckpoint)
+{
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "durable_set_test_group";
+    std::filesystem::remove_all(dir);
+
+    DurableOptions options;
+    options.group_commit_records = 10;
+    options.group_commit_delay = std::chrono::hours(1);
+    options.checkpoint_log_bytes = 1000;
+
+    {
+        DurableSet<std::string> set(dir.string(), options);
+        uint64_t empty_log = set.log_size();
+
+        for (int i = 0; i < 9; i++)
+            set.insert("chave " + std::to_string(i));
+        EXPECT_EQ(set.pending_count(), 9);
+        EXPECT_EQ(set.log_size(), empty_log);
+
+        set.insert("chave 9");
+        EXPECT_EQ(set.pending_count(), 0);
+        EXPECT_GT(set.log_size(), empty_log);
+
+        for (int i = 10; i < 200; i++)
+            set.insert("chave " + std::to_string(i));
+        EXPECT_LT(set.log_size(), options.checkpoint_log_bytes);
+        EXPECT_TRUE(std::filesystem::exists(dir / "checkpoint"));
+    }
+
+    DurableSet<std::string> recovered(dir.string(), options);
+    EXPECT_EQ(recovered.size(), 200);
+    EXPECT_TRUE(recovered.contains("chave 123"));
+
+    EXPECT_THROW(DurableSet<int>{dir.string()}, std::runtime_error);
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(DurableSetTest, FailedCheckpointKeepsLogUsable)
+{
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "durable_set_test_checkpoint";
+    std::filesystem::remove_all(dir);
+
+    {
+        DurableSet<int> set(dir.string());
+        for (int i = 0; i < 100; i++)
+            set.insert(i);
+
+        // Um diretório no lugar do log temporário faz a criação do novo log falhar
+        std::filesystem::create_directories(dir / "wal.tmp");
+        EXPECT_THROW(set.checkpoint(), std::runtime_error);
+        std::filesystem::remove(dir / "wal.tmp");
+
+        for (int i = 100; i < 200; i++)
+            set.insert(i);
+        set.erase(0);
+        set.sync();
+
+        set.checkpoint();
+        set.insert(500);
+    }
+
+    DurableSet<int> recovered(dir.string());
+    EXPECT_EQ(recovered.size(), 200u);
+    EXPECT_FALSE(recovered.contains(0));
+    EXPECT_TRUE(recovered.contains(199));
+    EXPECT_TRUE(recovered.contains(500));
+
+    std::filesystem::remove_all(dir);
+}
+
+// --- Geradores de carga e traces ---
+TEST(WorkloadTest, SeededGeneratorsAreDeterministic)
+{
+    EXPECT_EQ(workload::keys(workload::Pattern::Uniform, 1000, 7), workload::keys(workload::Pattern::Uniform, 1000, 7));
+    EXPECT_NE(workload::keys(workload::Pattern::Uniform, 1000, 7), workload::keys(workload::Pattern::Uniform, 1000, 8));
+    EXPECT_EQ(workload::churn({1, 2, 3}, 500, 3), workload::churn({1, 2, 3}, 500, 3));
+
+    std::vector<int64_t> alternating = workload::keys(workload::Pattern::Alternating, 5, 0);
+    EXPECT_EQ(alternating, (std::vector<int64_t>{0, 4, 1, 3, 2}));
+
+    std::vector<int64_t> clustered = workload::keys(workload::Pattern::Clustered, 2 * workload::CLUSTER_SIZE, 1);
+    EXPECT_EQ(clustered[workload::CLUSTER_SIZE - 1], clustered[0] + static_cast<int64_t>(workload::CLUSTER_SIZE) - 1);
+
+    EXPECT_EQ(workload::parse_pattern("descending"), workload::Pattern::Descending);
+    EXPECT_THROW(workload::parse_pattern("gaussiana"), std::invalid_argument);
+
+    // Com expoente 1, a chave mais popular recebe cerca de 1 / H(1000), uns 13% das buscas
+    std::vector<int64_t> keys = workload::keys(workload::Pattern::Ascending, 1000, 0);
+    std::vector<workload::Operation> lookups = workload::zipf_lookups(keys, 100'000, 1.0, 5);
+    std::vector<size_t> hits(keys.size());
+    for (const workload::Operation &lookup : lookups)
+    {
+        ASSERT_EQ(lookup.type, workload::OpType::Contains);
+        ASSERT_GE(lookup.key, 0);
+        ASSERT_LT(lookup.key, 1000);
+        hits[lookup.key]++;
+    }
+
+    std::sort(hits.rbegin(), hits.rend());
+    EXPECT_GT(hits[0], 11'000u);
+    EXPECT_LT(hits[0], 16'000u);
+    EXPECT_GT(hits[0], 5 * hits[9]);
+}
+
+TEST(WorkloadTest, AdversarialPatternsAndTraceRoundTrip)
+{
+    for (workload::Pattern pattern : {workload::Pattern::Ascending, workload::Pattern::Descending, workload::Pattern::Alternating,
+                                      workload::Pattern::Uniform, workload::Pattern::Clustered})
+    {
+        std::vector<workload::Operation> operations = workload::churn(workload::keys(pattern, 3000, 11), 6000, 12);
+
+        Set<int64_t> set;
+        std::set<int64_t> expected;
+        for (const workload::Operation &operation : operations)
+        {
+            if (operation.type == workload::OpType::Insert)
+                set.insert(operation.key), expected.insert(operation.key);
+            else if (operation.type == workload::OpType::Erase)
+                set.erase(operation.key), expected.erase(operation.key);
+            else
+                ASSERT_TRUE(set.contains(operation.key)) << workload::to_string(pattern);
+        }
+
+        ASSERT_EQ(set.size(), expected.size()) << workload::to_string(pattern);
+        std::vector<int64_t> keys;
+        for (int64_t key : set.inorder())
+            keys.push_back(key);
+        EXPECT_TRUE(std::equal(keys.begin(), keys.end(), expected.begin())) << workload::to_string(pattern);
+    }
+
+    std::vector<workload::Operation> operations = workload::churn(workload::keys(workload::Pattern::Uniform, 100, 1), 100, 2);
+    operations.push_back({workload::OpType::Clear, 0});
+    operations.push_back({workload::OpType::Successor, INT64_MIN});
+    operations.push_back({workload::OpType::Predecessor, INT64_MAX});
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "workload_test.trace";
+    workload::write_trace(path.string(), operations);
+    EXPECT_EQ(workload::read_trace(path.string()), operations);
+
+    // Registro truncado no fim do arquivo
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_THROW(workload::read_trace(path.string()), std::runtime_error);
+
+    std::stringstream ascending;
+    {
+        workload::TraceWriter writer(ascending);
+        for (int64_t key = 0; key < 1000; key++)
+            writer.append({workload::OpType::Insert, key});
+    }
+    EXPECT_EQ(ascending.str().size(), 16u + 2 * 1000); // Um byte de operação e um de diferença
+
+    std::stringstream invalid("NAOTRACE00000000");
+    EXPECT_THROW(workload::TraceReader{invalid}, std::runtime_error);
+
+    std::filesystem::remove(path);
+}
+
+TEST(RecordingSetTest, RecordsEveryOperationInOrder)
+{
+    Set<int> set;
+    std::stringstream trace;
+    {
+        RecordingSet<int> recorder(set, trace);
+        recorder.insert(10);
+        recorder.insert(-5);
+        EXPECT_TRUE(recorder.contains(10));
+        EXPECT_EQ(recorder.find_next(-5), 10);
+        EXPECT_EQ(recorder.find_prev(-5), std::nullopt);
+        EXPECT_THROW(recorder.successor(10), std::runtime_error); // Registrada mesmo lançando exceção
+        recorder.erase(10);
+        EXPECT_EQ(recorder.size(), 1u);
+        EXPECT_EQ(recorder.recorded(), 7u);
+        recorder.flush();
+    }
+
+    EXPECT_EQ(set.size(), 1u);
+    EXPECT_TRUE(set.contains(-5));
+
+    using workload::OpType;
+    std::vector<workload::Operation> expected{{OpType::Insert, 10}, {OpType::Insert, -5}, {OpType::Contains, 10},
+                                              {OpType::Successor, -5}, {OpType::Predecessor, -5},
+                                              {OpType::Successor, 10}, {OpType::Erase, 10}};
+
+    workload::TraceReader reader(trace);
+    std::vector<workload::Operation> operations;
+    workload::Operation operation;
+    while (reader.next(operation))
+        operations.push_back(operation);
+
+    EXPECT_EQ(operations, expected);
+}
+
+TEST(RecordingSetTest, ReplayReproducesRecordedSet)
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "recording_set_test.trace";
+
+    Set<long long> original;
+    {
+        std::ofstream out(path, std::ios::binary);
+        RecordingSet<long long> recorder(original, out);
+
+        for (const workload::Operation &operation : workload::churn(workload::keys(workload::Pattern::Uniform, 2000, 3), 4000, 4))
+        {
+            if (operation.type == workload::OpType::Insert)
+                recorder.insert(operation.key);
+            else if (operation.type == workload::OpType::Erase)
+                recorder.erase(operation.key);
+            else
+                recorder.contains(operation.key);
+        }
+
+        recorder.clear();
+        for (long long key = 0; key < 100; key++)
+            recorder.insert(key * key);
+    } // O destrutor grava o que restou no buffer
+
+    Set<long long> replayed{-1};
+    for (const workload::Operation &operation : workload::read_trace(path.string()))
+    {
+        if (operation.type == workload::OpType::Insert)
+            replayed.insert(operation.key);
+        else if (operation.type == workload::OpType::Erase)
+            replayed.erase(operation.key);
+        else if (operation.type == workload::OpType::Clear)
+            replayed.clear();
+    }
+
+    auto keys = [](const Set<long long> &set)
+    {
+        std::vector<long long> result;
+        set.for_each([&](long long key) { result.push_back(key); });
+        return result;
+    };
+    EXPECT_EQ(replayed.size(), 100u);
+    EXPECT_EQ(keys(replayed), keys(original));
+
+    std::filesystem::remove(path);
+}
+
+// --- Histogramas de latência ---
+TEST(LatencyHistogramTest, BucketsBoundRelativeErrorAndPercentiles)
+{
+    for (uint64_t value : {0ull, 1ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull, ~0ull})
+    {
+        size_t bucket = LatencyHistogram::bucket_of(value);
+        ASSERT_LT(bucket, LatencyHistogram::BUCKETS);
+        uint64_t upper = LatencyHistogram::bucket_upper(bucket);
+        EXPECT_GE(upper, value);
+        EXPECT_LE(static_cast<double>(upper - value), static_cast<double>(value) / 32.0) << value;
+        if (bucket + 1 < LatencyHistogram::BUCKETS)
+        {
+            EXPECT_EQ(LatencyHistogram::bucket_of(upper + 1), bucket + 1);
+        }
+    }
+
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.percentile(0.5), 0u);
+
+    for (uint64_t i = 1; i <= 10'000; i++)
+        histogram.record(i);
+
+    EXPECT_EQ(histogram.count(), 10'000u);
+    EXPECT_EQ(histogram.max(), 10'000u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 5000.5);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.5)), 5000.0, 5000.0 / 32);
+    EXPECT_NEAR(static_cast<double>(histogram.percentile(0.99)), 9900.0, 9900.0 / 32);
+    EXPECT_EQ(histogram.percentile(1.0), 10'000u);
+    EXPECT_EQ(histogram.percentile(0.0), 1u);
+
+    LatencyHistogram other;
+    other.record(1'000'000);
+    histogram.merge(other);
+    EXPECT_EQ(histogram.max(), 1'000'000u);
+    EXPECT_EQ(histogram.count(), 10'001u);
+}
+
+TEST(LatencyHistogramTest, TimedSetRecordsPerOperationAcrossThreads)
+{
+    LatencyRecorder recorder;
+    Set<int> set;
+    TimedSet<int> timed(set, recorder);
+
+    for (int i = 0; i < 100; i++)
+        timed.insert(i);
+    for (int i = 0; i < 50; i++)
+        timed.contains(i);
+    EXPECT_THROW(timed.successor(99), std::runtime_error); // Medida mesmo lançando exceção
+    timed.erase(0);
+
+    ConcurrentSet<int> shared;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+        threads.emplace_back([&, t]()
+                             {
+                                 TimedSet<int, ConcurrentSet<int>> local(shared, recorder);
+                                 for (int i = 0; i < 250; i++)
+                                     local.insert(t * 1000 + i); });
+    for (std::thread &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(shared.size(), 1000u);
+    EXPECT_EQ(recorder.histogram(workload::OpType::Insert).count(), 1100u);
+    EXPECT_EQ(recorder.histogram(workload::OpType::Contains).count(), 50u);
+    EXPECT_EQ(recorder.histogram(workload::OpType::Successor).count(), 1u);
+    EXPECT_EQ(recorder.histogram(workload::OpType::Erase).count(), 1u);
+    EXPECT_EQ(recorder.histogram(workload::OpType::Clear).count(), 0u);
+
+    std::ostringstream text;
+    recorder.write_text(text);
+    EXPECT_NE(text.str().find("p99.9 ns"), std::string::npos);
+    EXPECT_NE(text.str().find("insert"), std::string::npos);
+    EXPECT_EQ(text.str().find("clear"), std::string::npos);
+
+    std::ostringstream json;
+    recorder.write_json(json);
+    EXPECT_EQ(json.str().front(), '{');
+    EXPECT_NE(json.str().find("\"insert\": {\"count\": 1100"), std::string::npos);
+    EXPECT_NE(json.str().find("\"p999\""), std::string::npos);
+
+    recorder.reset();
+    EXPECT_EQ(recorder.histogram(workload::OpType::Insert).count(), 0u);
+}
+
+// --- FrozenSet (layout de Eytzinger mapeável do disco) ---
+TEST(FrozenSetTest, QueriesMatchSourceSet)
+{
+    Set<int> source;
+    for (int i = 0; i < 1000; i++)
+        source.insert(i * 3);
+
+    FrozenSet<int> frozen(source);
+    EXPECT_EQ(frozen.size(), 1000);
+    EXPECT_EQ(frozen.try_min(), 0);
+    EXPECT_EQ(frozen.try_max(), 2997);
+
+    for (int key = -2; key < 3002; key++)
+    {
+        EXPECT_EQ(frozen.contains(key), source.contains(key)) << key;
+
+        auto it = frozen.lower_bound(key);
+        std::optional<int> expected = source.contains(key) ? std::optional<int>(key) : source.find_next(key);
+        if (expected)
+        {
+            ASSERT_NE(it, frozen.end());
+            EXPECT_EQ(*it, *expected);
+        }
+        else
+            EXPECT_EQ(it, frozen.end());
+    }
+
+    std::vector<int> keys(frozen.begin(), frozen.end());
+    ASSERT_EQ(keys.size(), 1000);
+    for (int i = 0; i < 1000; i++)
+        EXPECT_EQ(keys[i], i * 3);
+
+    FrozenSet<int> empty{Set<int>()};
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.begin(), empty.end());
+    EXPECT_FALSE(empty.contains(0));
+    EXPECT_FALSE(empty.try_max().has_value());
+}
+
+TEST(FrozenSetTest, WriteAndOpenMappedFile)
+{
+    std::string path = (std::filesystem::temp_directory_path() / "avl_frozen_test.bin").string();
+
+    Set<double> source;
+    for (int i = 1; i <= 777; i++)
+        source.insert(1.0 / i);
+    FrozenSet<double>::write(source, path);
+
+    {
+        FrozenSet<double> mapped = FrozenSet<double>::open(path);
+        EXPECT_EQ(mapped.size(), 777);
+        EXPECT_TRUE(mapped.contains(0.5));
+        EXPECT_FALSE(mapped.contains(0.3));
+        EXPECT_EQ(*mapped.lower_bound(0.3), 1.0 / 3);
+        EXPECT_EQ(mapped.try_max(), 1.0);
+
+        FrozenSet<double> moved = std::move(mapped);
+        EXPECT_EQ(moved.size(), 777);
+
+        size_t visited = 0;
+        double previous = 0.0;
+        bool ordered = true;
+        moved.for_each([&](double key)
+                       { ordered = ordered and key > previous; previous = key; visited++; });
+        EXPECT_TRUE(ordered);
+        EXPECT_EQ(visited, 777);
+    }
+
+    EXPECT_THROW(FrozenSet<int>::open(path), std::runtime_error); // Tipo diferente
+
+    std::filesystem::resize_file(path, 100); // Truncado
+    EXPECT_THROW(FrozenSet<double>::open(path), std::runtime_error);
+    std::filesystem::remove(path);
+
+    EXPECT_THROW(FrozenSet<double>::open(path), std::runtime_error); // Inexistente
+}
+
+// --- Testes ConcurrentSet ---
+TEST(ConcurrentSetTest, ParallelWritersAndReaders)
+{
+    ConcurrentSet<int> cs;
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 4; t++)
+        threads.emplace_back([&cs, t]()
+                             {
+                                 for (int i = 0; i < 500; i++)
+                                     cs.insert(t * 1000 + i); });
+
+    for (int t = 0; t < 4; t++)
+        threads.emplace_back([&cs]()
+                             {
+                                 for (int i = 0; i < 500; i++)
+                                     cs.contains(i); });
+
+    for (std::thread &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(cs.size(), 2000);
+    EXPECT_EQ(cs.try_min(), 0);
+    EXPECT_EQ(cs.try_max(), 3499);
+}
+
+TEST(ConcurrentSetTest, BatchOperations)
+{
+    ConcurrentSet<int> cs = {1, 2, 3};
+    std::vector<int> more = {4, 5, 6};
+    cs.insert_all(more.begin(), more.end());
+
+    std::vector<int> removed = {1, 6, 42};
+    cs.erase_all(removed.begin(), removed.end());
+
+    std::vector<int> queries = {1, 2, 5, 6};
+    std::vector<bool> answers;
+    cs.contains_all(queries.begin(), queries.end(), std::back_inserter(answers));
+    EXPECT_EQ(answers, std::vector<bool>({false, true, true, false}));
+
+    EXPECT_EQ(cs.read([](const Set<int> &set)
+                      { return set.size(); }),
+              4);
+
+    cs.write([](Set<int> &set)
+             { set.insert(100); });
+
+    Set<int> snapshot = cs.snapshot();
+    EXPECT_EQ(snapshot.size(), 5);
+    EXPECT_EQ(cs.try_pop_max(), 100);
+    EXPECT_EQ(cs.try_pop_min(), 2);
+    EXPECT_TRUE(snapshot.contains(100));
+}
+
+// --- Testes EpochSet (leitores sem lock) ---
+TEST(EpochSetTest, BasicOperations)
+{
+    EpochSet<int> es;
+    EXPECT_TRUE(es.empty());
+    EXPECT_FALSE(es.try_min().has_value());
+
+    for (int i = 1; i <= 100; i++)
+        es.insert(i);
+    es.insert(50); // Duplicado
+
+    EXPECT_EQ(es.size(), 100);
+    EXPECT_TRUE(es.contains(1));
+    EXPECT_TRUE(es.contains(100));
+    EXPECT_FALSE(es.contains(101));
+    EXPECT_EQ(es.try_min(), 1);
+    EXPECT_EQ(es.try_max(), 100);
+
+    for (int i = 1; i <= 100; i += 2)
+        es.erase(i);
+
+    EXPECT_EQ(es.size(), 50);
+    EXPECT_FALSE(es.contains(1));
+    EXPECT_EQ(es.find_next(1), 2);
+    EXPECT_EQ(es.find_prev(100), 98);
+
+    std::vector<int> batch = {1000, 1001, 2};
+    es.insert_all(batch.begin(), batch.end());
+    EXPECT_EQ(es.size(), 52);
+    es.erase_all(batch.begin(), batch.end());
+    EXPECT_EQ(es.size(), 49);
+
+    es.clear();
+    EXPECT_TRUE(es.empty());
+    EXPECT_EQ(es.size(), 0);
+}
+
+TEST(EpochSetTest, ReadersSeeStableKeysWhileWriterChurns)
+{
+    EpochSet<int> es;
+    for (int i = 0; i < 200; i += 2)
+        es.insert(i);
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> misses{0};
+    std::vector<std::thread> readers;
+
+    for (int r = 0; r < 3; r++)
+        readers.emplace_back([&es, &stop, &misses]()
+                             {
+                                 while (!stop.load())
+                                     for (int i = 0; i < 200; i += 2)
+                                         if (!es.contains(i))
+                                             misses++; });
+
+    for (int round = 0; round < 2000; round++)
+    {
+        int key = 2 * (round % 100) + 1; // Apenas ímpares mudam
+        if (round % 3 == 0)
+            es.erase(key);
+        else
+            es.insert(key);
+    }
+
+    stop = true;
+    for (std::thread &reader : readers)
+        reader.join();
+
+    EXPECT_EQ(misses.load(), 0);
+
+    es.reclaim(); // Sem leitores ativos, todos os nós aposentados podem ser liberados
+    EXPECT_EQ(es.retired_count(), 0);
+}
+
+// --- Testes OptimisticSet (locks por nó e buscas otimistas) ---
+TEST(OptimisticSetTest, BasicOperations)
+{
+    OptimisticSet<int> os;
+    EXPECT_TRUE(os.empty());
+    EXPECT_FALSE(os.contains(1));
+    EXPECT_FALSE(os.erase(1));
+
+    for (int i = 1; i <= 100; i++)
+        EXPECT_TRUE(os.insert(i));
+    EXPECT_FALSE(os.insert(50)); // Duplicado
+
+    EXPECT_EQ(os.size(), 100);
+    EXPECT_LE(os.height(), 8); // Árvore AVL com 100 nós
+
+    // Remove nós internos (viram nós de roteamento) e folhas
+    for (int i = 1; i <= 100; i += 2)
+        EXPECT_TRUE(os.erase(i));
+    EXPECT_FALSE(os.erase(1));
+
+    EXPECT_EQ(os.size(), 50);
+    EXPECT_FALSE(os.contains(51));
+    EXPECT_TRUE(os.contains(52));
+
+    EXPECT_TRUE(os.insert(51)); // Reaproveita um nó de roteamento, se ainda existir
+    EXPECT_TRUE(os.contains(51));
+
+    std::vector<int> keys;
+    os.for_each([&keys](int key)
+                { keys.push_back(key); });
+    ASSERT_EQ(keys.size(), 51);
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+}
+
+TEST(OptimisticSetTest, ConcurrentWritersStress)
+{
+    OptimisticSet<int> os;
+    const int threads = 4;
+    const int keysPerThread = 2000;
+    std::vector<std::thread> workers;
+    std::atomic<int> errors{0};
+
+    // Cada thread insere e remove apenas as chaves congruentes ao seu índice, enquanto
+    // todas disputam os mesmos nós internos da árvore.
+    for (int t = 0; t < threads; t++)
+        workers.emplace_back([&os, &errors, t]()
+                             {
+                                 for (int round = 0; round < 3; round++)
+                                 {
+                                     for (int i = 0; i < keysPerThread; i++)
+                                         if (!os.insert(i * threads + t))
+                                             errors++;
+                                     for (int i = 0; i < keysPerThread; i++)
+                                         if (!os.contains(i * threads + t))
+                                             errors++;
+                                     for (int i = 0; i < keysPerThread; i++)
+                                         if (!os.erase(i * threads + t))
+                                             errors++;
+                                 }
+
+                                 for (int i = 0; i < keysPerThread; i++)
+                                     os.insert(i * threads + t);
+                                 for (int i = 0; i < keysPerThread; i += 2)
+                                     if (!os.erase(i * threads + t))
+                                         errors++; });
+
+    for (std::thread &worker : workers)
+        worker.join();
+
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_EQ(os.size(), threads * keysPerThread / 2);
+
+    std::vector<int> keys;
+    os.for_each([&keys](int key)
+                { keys.push_back(key); });
+    ASSERT_EQ(keys.size(), os.size());
+    for (int key : keys)
+        EXPECT_EQ((key / threads) % 2, 1);
+
+    // Sem escritas em andamento, todo desbalanceamento relaxado já foi reparado. Nós de
+    // roteamento têm dois filhos, então a árvore tem no máximo 2n + 1 nós.
+    EXPECT_LE(os.height(), 1.45 * std::log2(2 * keys.size() + 3));
+}
+
+// --- Testes ShardedSet (particionado por faixas) ---
+TEST(ShardedSetTest, SplitsShardsAndKeepsOrder)
+{
+    ShardedSet<int> ss(4);
+    EXPECT_TRUE(ss.empty());
+    EXPECT_FALSE(ss.try_min().has_value());
+    EXPECT_THROW(ss.minimum(), std::runtime_error);
+
+    // Inserção crescente: todas as chaves caem no último shard, que precisa ser dividido
+    for (int i = 0; i < 20000; i++)
+        ss.insert(i);
+    ss.insert(10); // Duplicado
+
+    EXPECT_EQ(ss.size(), 20000);
+    EXPECT_GE(ss.shard_count(), 4u);
+    EXPECT_EQ(ss.minimum(), 0);
+    EXPECT_EQ(ss.maximum(), 19999);
+    EXPECT_TRUE(ss.contains(12345));
+    EXPECT_FALSE(ss.contains(20000));
+
+    std::vector<size_t> sizes = ss.shard_sizes();
+    EXPECT_EQ(std::accumulate(sizes.begin(), sizes.end(), size_t{0}), 20000u);
+    for (size_t size : sizes)
+        EXPECT_LE(size, 20000u / 4 * 3 / 2 + 1);
+
+    int expected = 0;
+    bool ordered = true;
+    ss.for_each([&expected, &ordered](int key)
+                { ordered = ordered and key == expected++; });
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(expected, 20000);
+
+    // Esvaziar o início do intervalo faz os shards vazios serem unidos
+    size_t shardsBefore = ss.shard_count();
+    for (int i = 0; i < 15000; i++)
+        ss.erase(i);
+    EXPECT_EQ(ss.size(), 5000);
+    EXPECT_LT(ss.shard_count(), shardsBefore);
+    EXPECT_EQ(ss.minimum(), 15000);
+
+    ss.clear();
+    EXPECT_TRUE(ss.empty());
+    EXPECT_EQ(ss.shard_count(), 1);
+}
+
+TEST(ShardedSetTest, RebalancesAgainAfterFailedSplit)
+{
+    ShardedSet<FragileKey> ss(4);
+    for (int i = 0; i < 2047; i++)
+        ss.insert(FragileKey(i));
+    EXPECT_EQ(ss.shard_count(), 1u);
+
+    // A inserção seguinte dispara a divisão, que falha ao copiar as chaves
+    FragileKey::copies_left = 5;
+    EXPECT_THROW(ss.insert(FragileKey(2047)), std::bad_alloc);
+    FragileKey::copies_left = -1;
+    EXPECT_EQ(ss.shard_count(), 1u);
+
+    ss.insert(FragileKey(2048));
+    EXPECT_GT(ss.shard_count(), 1u);
+    EXPECT_EQ(ss.size(), 2049u);
+}
+
+TEST(ShardedSetTest, ConcurrentInsertsWhileRebalancing)
+{
+    ShardedSet<int> ss(4);
+    std::vector<std::thread> writers;
+
+    for (int t = 0; t < 4; t++)
+        writers.emplace_back([&ss, t]()
+                             {
+                                 for (int i = 0; i < 5000; i++)
+                                     ss.insert(i * 4 + t); });
+
+    for (std::thread &writer : writers)
+        writer.join();
+
+    EXPECT_EQ(ss.size(), 20000);
+
+    std::vector<int> keys;
+    ss.for_each([&keys](int key)
+                { keys.push_back(key); });
+    ASSERT_EQ(keys.size(), 20000);
+    for (int i = 0; i < 20000; i++)
+        EXPECT_EQ(keys[i], i);
+}
+
+// --- Testes PersistentSet ---
+namespace
+{
+    std::vector<int> toVector(const PersistentSet<int> &set)
+    {
+        std::vector<int> keys;
+        set.for_each([&keys](int key)
+                     { keys.push_back(key); });
+        return keys;
+    }
+}
+
+TEST(PersistentSetTest, SnapshotIsIsolatedFromLaterChanges)
+{
+    PersistentSet<int> ps = {10, 5, 15, 3, 7};
+    PersistentSet<int> snap = ps.snapshot();
+
+    ps.insert(20);
+    ps.erase(5);
+    ps.erase(3);
+
+    EXPECT_EQ(toVector(snap), std::vector<int>({3, 5, 7, 10, 15}));
+    EXPECT_EQ(toVector(ps), std::vector<int>({7, 10, 15, 20}));
+    EXPECT_EQ(snap.size(), 5);
+    EXPECT_EQ(ps.size(), 4);
+
+    snap.insert(1); // O snapshot também pode evoluir sem afetar a versão original
+    EXPECT_EQ(snap.try_min(), 1);
+    EXPECT_EQ(ps.try_min(), 7);
+}
+
+TEST(PersistentSetTest, ManyVersionsStayValid)
+{
+    PersistentSet<int> ps;
+    std::vector<PersistentSet<int>> versions;
+
+    for (int i = 0; i < 100; i++)
+    {
+        versions.push_back(ps.snapshot());
+        ps.insert(i);
+    }
+
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(versions[i].size(), static_cast<size_t>(i));
+        EXPECT_EQ(versions[i].contains(i), false);
+        if (i > 0)
+        {
+            EXPECT_EQ(versions[i].try_max(), i - 1);
+        }
+    }
+
+    ps.clear();
+    EXPECT_TRUE(ps.empty());
+    EXPECT_EQ(versions[99].size(), 99);
+}
+
+// --- Cópia com compartilhamento (copy-on-write) ---
+TEST_F(AVLSetTest, CopiesShareUntilModified)
+{
+    for (int i = 0; i < 100; i++)
+        s.insert(i);
+
+    Set<int> copy1(s);
+    Set<int> copy2;
+    copy2 = s;
+
+    copy1.insert(1000);
+    copy1.erase(0);
+    copy2.pop_max();
+    s.erase(50);
+
+    EXPECT_EQ(s.size(), 99);
+    EXPECT_FALSE(s.contains(50));
+    EXPECT_TRUE(s.contains(0));
+    EXPECT_FALSE(s.contains(1000));
+    EXPECT_EQ(s.minimum(), 0);
+    EXPECT_EQ(s.maximum(), 99);
+
+    EXPECT_EQ(copy1.size(), 100);
+    EXPECT_TRUE(copy1.contains(50));
+    EXPECT_FALSE(copy1.contains(0));
+    EXPECT_EQ(copy1.minimum(), 1);
+    EXPECT_EQ(copy1.maximum(), 1000);
+
+    EXPECT_EQ(copy2.size(), 99);
+    EXPECT_TRUE(copy2.contains(50));
+    EXPECT_EQ(copy2.maximum(), 98);
+}
+
+TEST_F(AVLSetTest, CopyOutlivesOriginal)
+{
+    Set<int> copy;
+    {
+        Set<int> original = {5, 3, 8, 1, 4};
+        copy = original;
+        original.insert(100);
+    }
+
+    copy.erase(3); // A árvore agora pertence apenas à cópia
+    verifyElements(copy, {1, 4, 5, 8});
+}
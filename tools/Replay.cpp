@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "commandLine/CommandLine.hpp"
+#include "concurrentSet/ConcurrentSet.hpp"
+#include "concurrentSet/EpochSet.hpp"
+#include "latency/LatencyHistogram.hpp"
+#include "set/Set.hpp"
+#include "workload/Trace.hpp"
+
+// Reexecuta um trace contra uma ou mais implementações de conjunto e mede a vazão e os
+// percentis de latência por tipo de operação.
+//
+// Uso: Replay --trace arquivo [--structures Set,std::set,ConcurrentSet,EpochSet] [--repeat 3]
+//              [--json arquivo]
+//
+// O trace é lido inteiro para a memória antes de medir. Cada repetição começa de uma
+// estrutura vazia e faz duas passadas: uma sem instrumentação, que dá a vazão, e outra
+// com o relógio lido em volta de cada operação, que dá as latências (o custo da leitura,
+// algumas dezenas de nanossegundos, entra nas latências mas não na vazão). As latências
+// vão para histogramas log-linear (latency/LatencyHistogram.hpp), com memória fixa
+// qualquer que seja o tamanho do trace.
+
+namespace
+{
+    using Key = int64_t;
+
+    struct StdSet
+    {
+        std::set<Key> set;
+
+        void insert(Key key) { set.insert(key); }
+        void erase(Key key) { set.erase(key); }
+        bool contains(Key key) const { return set.count(key) != 0; }
+        void clear() { set.clear(); }
+
+        std::optional<Key> find_next(Key key) const
+        {
+            auto it = set.upper_bound(key);
+            return it == set.end() ? std::nullopt : std::optional<Key>(*it);
+        }
+
+        std::optional<Key> find_prev(Key key) const
+        {
+            auto it = set.lower_bound(key);
+            return it == set.begin() ? std::nullopt : std::optional<Key>(*std::prev(it));
+        }
+    };
+
+    /**
+     * @brief Executa uma operação e retorna um valor derivado do resultado, para que a
+     * consulta não seja descartada pelo compilador.
+     */
+    template <class Structure>
+    Key apply(Structure &structure, const workload::Operation &operation)
+    {
+        switch (operation.type)
+        {
+        case workload::OpType::Insert:
+            structure.insert(operation.key);
+            return 0;
+        case workload::OpType::Erase:
+            structure.erase(operation.key);
+            return 0;
+        case workload::OpType::Contains:
+            return structure.contains(operation.key);
+        case workload::OpType::Successor:
+            return structure.find_next(operation.key).value_or(0);
+        case workload::OpType::Predecessor:
+            return structure.find_prev(operation.key).value_or(0);
+        case workload::OpType::Clear:
+            structure.clear();
+            return 0;
+        }
+
+        return 0;
+    }
+
+    // Destino dos resultados das consultas, para que não sejam eliminadas como código morto
+    volatile Key sink_result;
+
+    struct Result
+    {
+        std::string structure;
+        size_t operations;
+        double seconds;
+        std::unique_ptr<LatencyRecorder> latencies;
+    };
+
+    template <class Structure>
+    Result replay(const std::string &name, const std::vector<workload::Operation> &operations, size_t repeat)
+    {
+        Result result{name, operations.size(), 0.0, std::make_unique<LatencyRecorder>()};
+        Key sink = 0;
+
+        for (size_t r = 0; r < repeat; r++)
+        {
+            {
+                auto structure = std::make_unique<Structure>();
+                auto start = std::chrono::steady_clock::now();
+                for (const workload::Operation &operation : operations)
+                    sink += apply(*structure, operation);
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+                if (r == 0 or elapsed.count() < result.seconds)
+                    result.seconds = elapsed.count();
+            }
+
+            auto structure = std::make_unique<Structure>();
+            for (const workload::Operation &operation : operations)
+            {
+                auto start = std::chrono::steady_clock::now();
+                sink += apply(*structure, operation);
+                auto end = std::chrono::steady_clock::now();
+
+                result.latencies->record(operation.type, static_cast<uint64_t>(
+                                                             std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+            }
+        }
+
+        sink_result = sink;
+
+        std::ostringstream out;
+        out << name << ": " << operations.size() << " operacoes em " << std::fixed << std::setprecision(6) << result.seconds
+            << " s (" << std::setprecision(2) << static_cast<double>(operations.size()) / result.seconds / 1e6 << " Mops/s)\n";
+        result.latencies->write_text(out);
+
+        std::cout << out.str() << std::endl;
+
+        return result;
+    }
+
+    void write_json(const std::string &path, const std::string &trace, const std::vector<Result> &results)
+    {
+        std::ofstream out(path);
+        if (!out)
+            throw std::runtime_error("Nao foi possivel abrir o arquivo: " + path);
+
+        out << "{\n  \"trace\": \"" << cli::json_escape(trace) << "\",\n  \"results\": [\n";
+
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const Result &result = results[i];
+            out << "    {\"structure\": \"" << cli::json_escape(result.structure) << "\", \"operations\": " << result.operations
+                << ", \"seconds\": " << std::setprecision(9) << result.seconds << ", \"latency_ns\": ";
+            result.latencies->write_json(out);
+            out << "}" << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+
+        out << "  ]\n}\n";
+    }
+
+    struct Options
+    {
+        std::string trace;
+        std::vector<std::string> structures{"Set", "std::set", "ConcurrentSet", "EpochSet"};
+        size_t repeat{3};
+        std::string json;
+    };
+
+    Options parse(int argc, char *argv[])
+    {
+        Options options;
+
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            std::string flag = argv[i];
+            std::string value = argv[i + 1];
+
+            if (flag == "--trace")
+                options.trace = value;
+            else if (flag == "--structures")
+                options.structures = cli::split_list(value);
+            else if (flag == "--json")
+                options.json = value;
+            else if (flag == "--repeat")
+                options.repeat = std::max<size_t>(1, std::stoull(value));
+            else
+                throw std::invalid_argument("Opcao desconhecida: " + flag);
+        }
+
+        if (options.trace.empty())
+            throw std::invalid_argument("Informe o trace com --trace");
+
+        return options;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        Options options = parse(argc, argv);
+        std::vector<workload::Operation> operations = workload::read_trace(options.trace);
+
+        std::vector<Result> results;
+
+        for (const std::string &structure : options.structures)
+        {
+            if (structure == "Set")
+                results.push_back(replay<Set<Key>>(structure, operations, options.repeat));
+            else if (structure == "std::set")
+                results.push_back(replay<StdSet>(structure, operations, options.repeat));
+            else if (structure == "ConcurrentSet")
+                results.push_back(replay<ConcurrentSet<Key>>(structure, operations, options.repeat));
+            else if (structure == "EpochSet")
+                results.push_back(replay<EpochSet<Key>>(structure, operations, options.repeat));
+            else
+                throw std::invalid_argument("Estrutura desconhecida: " + structure);
+        }
+
+        if (!options.json.empty())
+        {
+            write_json(options.json, options.trace, results);
+            std::cout << "Resultados gravados em " << options.json << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "workload/Trace.hpp"
+#include "workload/Workload.hpp"
+
+// Gera um trace de operações reproduzível com os geradores de workload.
+//
+// Uso: TraceGen --output arquivo [--workload inserts|zipf|churn] [--pattern uniform]
+//               [--size 100000] [--operations 1000000] [--zipf 0.99] [--seed 42]
+//
+//   inserts   inserções das `size` chaves do padrão
+//   zipf      inserções das chaves seguidas de `operations` buscas com popularidade Zipf
+//   churn     inserções das chaves seguidas de `operations` inserções, remoções e buscas
+
+namespace
+{
+    struct Options
+    {
+        std::string output;
+        std::string workload{"inserts"};
+        workload::Pattern pattern{workload::Pattern::Uniform};
+        size_t size{100'000};
+        size_t operations{1'000'000};
+        double zipf{0.99};
+        uint64_t seed{42};
+    };
+
+    Options parse(int argc, char *argv[])
+    {
+        Options options;
+
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            std::string flag = argv[i];
+            std::string value = argv[i + 1];
+
+            if (flag == "--output")
+                options.output = value;
+            else if (flag == "--workload")
+                options.workload = value;
+            else if (flag == "--pattern")
+                options.pattern = workload::parse_pattern(value);
+            else if (flag == "--size")
+                options.size = std::stoull(value);
+            else if (flag == "--operations")
+                options.operations = std::stoull(value);
+            else if (flag == "--zipf")
+                options.zipf = std::stod(value);
+            else if (flag == "--seed")
+                options.seed = std::stoull(value);
+            else
+                throw std::invalid_argument("Opcao desconhecida: " + flag);
+        }
+
+        if (options.output.empty())
+            throw std::invalid_argument("Informe o arquivo de saida com --output");
+
+        return options;
+    }
+
+    std::vector<workload::Operation> generate(const Options &options)
+    {
+        std::vector<int64_t> keys = workload::keys(options.pattern, options.size, options.seed);
+
+        if (options.workload == "inserts")
+            return workload::inserts(keys);
+
+        if (options.workload == "zipf")
+        {
+            std::vector<workload::Operation> operations = workload::inserts(keys);
+            std::vector<workload::Operation> lookups = workload::zipf_lookups(keys, options.operations, options.zipf, options.seed);
+            operations.insert(operations.end(), lookups.begin(), lookups.end());
+            return operations;
+        }
+
+        if (options.workload == "churn")
+            return workload::churn(keys, options.operations, options.seed);
+
+        throw std::invalid_argument("Carga desconhecida: " + options.workload);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        Options options = parse(argc, argv);
+        std::vector<workload::Operation> operations = generate(options);
+        workload::write_trace(options.output, operations);
+
+        std::cout << operations.size() << " operacoes gravadas em " << options.output << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}